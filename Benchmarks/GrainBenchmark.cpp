@@ -0,0 +1,167 @@
+// Offline timing of the grain engine. Not part of the plugin; build with
+// -DSUPERSAUCE_BENCHMARKS=ON and run GrainBenchmark from a release build.
+
+#include <JuceHeader.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "GrainEngine.h"
+#include "PitchShifter.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int ringSize = 1 << 18;
+    constexpr int secondsOfAudio = 10;
+
+    // Noise-filled delay ring, so grains read real data
+    std::vector<float> makeRing()
+    {
+        juce::Random random(1);
+        std::vector<float> ring((size_t) ringSize);
+        for (auto& sample : ring)
+            sample = random.nextFloat() * 2.0f - 1.0f;
+        return ring;
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    //==========================================================================
+    // Swarm mode: render cost against the number of grains playing at once.
+    // Runs are the processor's 32-sample swarm runs and the pool is topped up
+    // to the target count at the start of each, as batched scheduling does.
+    void benchmarkGrainCount(const GrainWindowTable& windows, const std::vector<float>& ring)
+    {
+        constexpr int runLength = 32;
+        constexpr int maxGrains = 1024;
+        constexpr int grainSize = 2880; // 60 ms
+        const int numRuns = static_cast<int>(sampleRate * secondsOfAudio) / runLength;
+
+        std::vector<float> envelope(runLength), gathered(runLength), output(runLength);
+
+        std::printf("Swarm grain count, %d s of mono audio in %d-sample runs\n", secondsOfAudio, runLength);
+        std::printf("%8s %12s %16s\n", "grains", "ms total", "ns/grain/sample");
+
+        for (int targetGrains = 32; targetGrains <= maxGrains; targetGrains *= 2)
+        {
+            GrainEngine<float> engine;
+            engine.prepare(envelope.data(), gathered.data(), windows, maxGrains);
+            juce::Random random(2);
+            int writeIndex = 0;
+            double grainSamples = 0.0;
+
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int run = 0; run < numRuns; ++run)
+            {
+                while (engine.getNumActiveGrains() < targetGrains)
+                {
+                    const int size = grainSize + random.nextInt(grainSize / 2);
+                    engine.startGrain((writeIndex - 2 * size) & (ringSize - 1), size, false, 0.1f,
+                                      GrainWindowTable::hann, random.nextInt(runLength));
+                }
+
+                grainSamples += static_cast<double>(engine.getNumActiveGrains()) * runLength;
+                std::fill(output.begin(), output.end(), 0.0f);
+                engine.render(ring.data(), ringSize - 1, output.data(), runLength);
+                writeIndex = (writeIndex + runLength) & (ringSize - 1);
+            }
+
+            const double elapsed = millisecondsSince(start);
+            std::printf("%8d %12.2f %16.3f\n", targetGrains, elapsed, elapsed * 1.0e6 / grainSamples);
+        }
+
+        std::printf("\n");
+    }
+
+    //==========================================================================
+    // Pitched grains: each grain resampling the ring at its own rate, against
+    // the two-pass path of unpitched grains followed by the delay-line pitch
+    // stage over the whole block. Stereo, normal-mode 512-sample blocks.
+    void benchmarkGrainPitch(const GrainWindowTable& windows, const std::vector<float>& ring)
+    {
+        constexpr int blockSize = 512;
+        constexpr int numChannels = 2;
+        constexpr int grainSize = 2880; // 60 ms
+        const int numBlocks = static_cast<int>(sampleRate * secondsOfAudio) / blockSize;
+
+        std::vector<float> envelope(blockSize), gathered(blockSize);
+        std::vector<std::vector<float>> output(numChannels, std::vector<float>(blockSize));
+        std::vector<std::vector<float>> tapScratch(PitchShifter::numTapScratchChannels, std::vector<float>(blockSize));
+        std::vector<float*> outputPointers, tapPointers;
+        for (auto& channel : output)
+            outputPointers.push_back(channel.data());
+        for (auto& channel : tapScratch)
+            tapPointers.push_back(channel.data());
+
+        // Renders secondsOfAudio with overlap grains per channel, all at rate, then
+        // optionally shifts the result by shifterRatio. Returns milliseconds.
+        auto time = [&](int overlap, float rate, float shifterRatio)
+        {
+            std::vector<GrainEngine<float>> engines(numChannels);
+            for (auto& engine : engines)
+                engine.prepare(envelope.data(), gathered.data(), windows);
+
+            PitchShifter shifter;
+            shifter.prepare(sampleRate, numChannels, tapPointers.data());
+
+            juce::Random random(3);
+            const int lag = static_cast<int>(grainSize * rate) + grainSize;
+            const int interval = grainSize / overlap;
+            int writeIndex = 0;
+            int nextOnset = 0;
+
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (; nextOnset < blockSize; nextOnset += interval)
+                    for (auto& engine : engines)
+                        engine.startGrain((writeIndex + nextOnset - lag) & (ringSize - 1), grainSize, false, 0.5f,
+                                          GrainWindowTable::hann, nextOnset, rate);
+                nextOnset -= blockSize;
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    std::fill(output[(size_t) channel].begin(), output[(size_t) channel].end(), 0.0f);
+                    engines[(size_t) channel].render(ring.data(), ringSize - 1, output[(size_t) channel].data(), blockSize);
+                }
+
+                if (shifterRatio != 1.0f)
+                    shifter.process(outputPointers.data(), numChannels, blockSize, shifterRatio, 1.0f);
+
+                writeIndex = (writeIndex + blockSize) & (ringSize - 1);
+            }
+
+            return millisecondsSince(start);
+        };
+
+        std::printf("Grain pitch, %d s of stereo audio in %d-sample blocks (ms)\n", secondsOfAudio, blockSize);
+        std::printf("%10s %12s %12s %12s\n", "overlap", "unpitched", "per-grain", "two-pass");
+
+        for (const int overlap : { 2, 8 })
+        {
+            const float octaveUp = 2.0f;
+            std::printf("%10d %12.2f %12.2f %12.2f\n", overlap,
+                        time(overlap, 1.0f, 1.0f),
+                        time(overlap, octaveUp, 1.0f),
+                        time(overlap, 1.0f, octaveUp));
+        }
+
+        std::printf("\n");
+    }
+}
+
+int main()
+{
+    GrainWindowTable windows;
+    windows.build();
+    const auto ring = makeRing();
+
+    benchmarkGrainCount(windows, ring);
+    benchmarkGrainPitch(windows, ring);
+    return 0;
+}
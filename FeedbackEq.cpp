@@ -0,0 +1,182 @@
+#include "FeedbackEq.h"
+
+template <typename SampleType>
+void FeedbackEq<SampleType>::prepare(double newSampleRate, int newNumChannels)
+{
+    sampleRate = static_cast<SampleType>(newSampleRate);
+    numChannels = newNumChannels;
+    highCutState.assign(static_cast<size_t>(maxStages * numChannels), SampleType(0));
+    lowCutState.assign(static_cast<size_t>(maxStages * numChannels), SampleType(0));
+    lastHighCut = lastLowCut = -1.0f; // snap to the first parameters instead of ramping
+    reset();
+}
+
+template <typename SampleType>
+void FeedbackEq<SampleType>::reset()
+{
+    std::fill(highCutState.begin(), highCutState.end(), SampleType(0));
+    std::fill(lowCutState.begin(), lowCutState.end(), SampleType(0));
+
+    current = target;
+    rampRemaining = 0;
+}
+
+template <typename SampleType>
+void FeedbackEq<SampleType>::setParameters(float highCut, float lowCut, int newSlope, int rampLength)
+{
+    if (newSlope != slope)
+    {
+        // Seed the second stages from the first so a slope change doesn't click
+        std::copy(highCutState.begin(), highCutState.begin() + numChannels, highCutState.begin() + numChannels);
+        std::fill(lowCutState.begin() + numChannels, lowCutState.end(), SampleType(0));
+        slope = newSlope;
+    }
+
+    if (highCut == lastHighCut && lowCut == lastLowCut)
+        return;
+
+    const bool isFirstUpdate = lastHighCut < 0.0f;
+    lastHighCut = highCut;
+    lastLowCut = lowCut;
+    target = computeCoefficients(highCut, lowCut);
+
+    if (isFirstUpdate || rampLength <= 0)
+    {
+        current = target;
+        rampRemaining = 0;
+        return;
+    }
+
+    step.lowPass = (target.lowPass - current.lowPass) / static_cast<SampleType>(rampLength);
+    step.highPass = (target.highPass - current.highPass) / static_cast<SampleType>(rampLength);
+    rampRemaining = rampLength;
+}
+
+template <typename SampleType>
+typename FeedbackEq<SampleType>::Coefficients FeedbackEq<SampleType>::computeCoefficients(float highCut, float lowCut) const
+{
+    using T = SampleType;
+    const T highCutFreq = juce::jmap(static_cast<T>(highCut), T(0), T(100), T(200), T(20000));
+    const T lowCutFreq = juce::jmap(static_cast<T>(lowCut), T(0), T(100), T(10), T(1000));
+
+    Coefficients c;
+    c.lowPass = std::exp(T(-2) * juce::MathConstants<T>::pi * (highCutFreq / sampleRate));
+    c.highPass = std::exp(T(-2) * juce::MathConstants<T>::pi * (lowCutFreq / sampleRate));
+    return c;
+}
+
+template <typename SampleType>
+void FeedbackEq<SampleType>::process(SampleType* const* channels, int channelsToProcess, int startSample, int numSamples)
+{
+    jassert(channelsToProcess <= numChannels);
+    channelsToProcess = juce::jmin(channelsToProcess, numChannels);
+
+    if (channelsToProcess == 2)
+    {
+        if (slope == slope12dB)
+            processStereo<2>(channels[0] + startSample, channels[1] + startSample, numSamples);
+        else
+            processStereo<1>(channels[0] + startSample, channels[1] + startSample, numSamples);
+        return;
+    }
+
+    if (slope == slope12dB)
+        processLanes<2>(channels, channelsToProcess, startSample, numSamples);
+    else
+        processLanes<1>(channels, channelsToProcess, startSample, numSamples);
+}
+
+template <typename SampleType>
+template <int numStages>
+void FeedbackEq<SampleType>::processStereo(SampleType* left, SampleType* right, int numSamples)
+{
+    // The state stays in locals for the whole run, so the two channels' recursions
+    // interleave in registers rather than round-tripping through the state vectors
+    std::array<SampleType, numStages> highCutLeft, highCutRight, lowCutLeft, lowCutRight;
+    for (size_t stage = 0; stage < numStages; ++stage)
+    {
+        const auto offset = stage * (size_t) numChannels;
+        highCutLeft[stage] = highCutState[offset];
+        highCutRight[stage] = highCutState[offset + 1];
+        lowCutLeft[stage] = lowCutState[offset];
+        lowCutRight[stage] = lowCutState[offset + 1];
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        advanceRamp();
+
+        const SampleType lp = current.lowPass, lpInput = SampleType(1) - lp;
+        const SampleType hp = current.highPass, hpInput = SampleType(1) - hp;
+        SampleType l = left[i], r = right[i];
+
+        // High cut: cascaded one-pole low-passes
+        for (size_t stage = 0; stage < numStages; ++stage)
+        {
+            highCutLeft[stage] = lp * highCutLeft[stage] + lpInput * l;
+            highCutRight[stage] = lp * highCutRight[stage] + lpInput * r;
+            l = highCutLeft[stage];
+            r = highCutRight[stage];
+        }
+
+        // Low cut: subtract a one-pole low-pass of the signal, once per stage
+        for (size_t stage = 0; stage < numStages; ++stage)
+        {
+            lowCutLeft[stage] = hp * lowCutLeft[stage] + hpInput * l;
+            lowCutRight[stage] = hp * lowCutRight[stage] + hpInput * r;
+            l = l - lowCutLeft[stage];
+            r = r - lowCutRight[stage];
+        }
+
+        left[i] = l;
+        right[i] = r;
+    }
+
+    for (size_t stage = 0; stage < numStages; ++stage)
+    {
+        const auto offset = stage * (size_t) numChannels;
+        highCutState[offset] = highCutLeft[stage];
+        highCutState[offset + 1] = highCutRight[stage];
+        lowCutState[offset] = lowCutLeft[stage];
+        lowCutState[offset + 1] = lowCutRight[stage];
+    }
+}
+
+template <typename SampleType>
+template <int numStages>
+void FeedbackEq<SampleType>::processLanes(SampleType* const* channels, int channelsToProcess, int startSample, int numSamples)
+{
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        advanceRamp();
+
+        const SampleType lp = current.lowPass;
+        const SampleType hp = current.highPass;
+
+        for (int ch = 0; ch < channelsToProcess; ++ch)
+        {
+            SampleType x = channels[ch][i];
+
+            // High cut: cascaded one-pole low-passes
+            for (int stage = 0; stage < numStages; ++stage)
+            {
+                auto& state = highCutState[(size_t) (stage * numChannels + ch)];
+                state = lp * state + (SampleType(1) - lp) * x;
+                x = state;
+            }
+
+            // Low cut: subtract a one-pole low-pass of the signal, once per stage
+            for (int stage = 0; stage < numStages; ++stage)
+            {
+                auto& state = lowCutState[(size_t) (stage * numChannels + ch)];
+                state = hp * state + (SampleType(1) - hp) * x;
+                x = x - state;
+            }
+
+            channels[ch][i] = x;
+        }
+    }
+}
+
+template class FeedbackEq<float>;
+template class FeedbackEq<double>;
@@ -0,0 +1,79 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+// Slope choices, shared by both sample precisions
+struct FeedbackEqBase
+{
+    enum Slope { slope6dB = 0, slope12dB, numSlopes };
+
+    static juce::StringArray getSlopeNames() { return { "6 dB/oct", "12 dB/oct" }; }
+};
+
+//==============================================================================
+// High-cut / low-cut tone shaping for the delay feedback path.
+//
+// Coefficients are only recomputed when eqHigh/eqLow/sampleRate change, and
+// then ramp linearly to the new values across the block so sweeps stay
+// smooth. All channels are filtered in lockstep from one shared coefficient
+// set; each filter is a recursion in time, so there is no width to vectorise
+// over beyond the channel lanes. Stereo keeps both channels' state in locals
+// for the run; other layouts use a loop over the lanes. Coefficients and state
+// are kept in the processing precision, since they recirculate through the
+// feedback loop.
+//==============================================================================
+template <typename SampleType>
+class FeedbackEq : public FeedbackEqBase
+{
+public:
+    void prepare (double sampleRate, int numChannels);
+    void reset();
+
+    // Call once per block. If the cutoffs moved, the coefficients ramp to the
+    // new values over rampLength samples of subsequent process() calls.
+    void setParameters (float highCut, float lowCut, int slope, int rampLength);
+
+    // Filters channels[ch][startSample .. startSample + numSamples) in place;
+    // channelsToProcess may not exceed the prepared count
+    void process (SampleType* const* channels, int channelsToProcess, int startSample, int numSamples);
+
+private:
+    struct Coefficients
+    {
+        SampleType lowPass = 0;  // one-pole pole for the high cut
+        SampleType highPass = 0; // one-pole pole for the low cut
+    };
+
+    Coefficients computeCoefficients (float highCut, float lowCut) const;
+
+    void advanceRamp() noexcept
+    {
+        if (rampRemaining > 0)
+        {
+            current.lowPass += step.lowPass;
+            current.highPass += step.highPass;
+            if (--rampRemaining == 0)
+                current = target;
+        }
+    }
+
+    template <int numStages>
+    void processStereo (SampleType* left, SampleType* right, int numSamples);
+    template <int numStages>
+    void processLanes (SampleType* const* channels, int channelsToProcess, int startSample, int numSamples);
+
+    SampleType sampleRate = 44100;
+    float lastHighCut = -1.0f, lastLowCut = -1.0f;
+    int slope = slope6dB;
+
+    Coefficients current, target, step;
+    int rampRemaining = 0;
+
+    // [stage * numChannels + channel]: two low-pass stages for the high cut and
+    // two for the low cut, with each stage's channel lanes side by side
+    static constexpr int maxStages = 2;
+    int numChannels = 0;
+    std::vector<SampleType> highCutState, lowCutState;
+};
@@ -0,0 +1,72 @@
+#include "FeedbackSaturator.h"
+
+template <typename SampleType>
+void FeedbackSaturator<SampleType>::prepare(int numChannels, int maxBlockSize)
+{
+    for (int i = x2; i < numFactors; ++i)
+    {
+        // Factor index i is 2^i, i.e. i cascaded half-band stages. Integer
+        // latency lets the loop make up for it by reading whole samples later.
+        oversamplers[i] = std::make_unique<juce::dsp::Oversampling<SampleType>>(
+            static_cast<size_t>(numChannels), static_cast<size_t>(i),
+            juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR, true, true);
+        oversamplers[i]->initProcessing(static_cast<size_t>(maxBlockSize));
+    }
+
+    reset();
+}
+
+template <typename SampleType>
+void FeedbackSaturator<SampleType>::reset()
+{
+    for (auto& oversampler : oversamplers)
+        if (oversampler != nullptr)
+            oversampler->reset();
+}
+
+template <typename SampleType>
+void FeedbackSaturator<SampleType>::setFactor(int newFactor)
+{
+    newFactor = juce::jlimit(0, numFactors - 1, newFactor);
+    if (newFactor == factor)
+        return;
+
+    factor = newFactor;
+    if (oversamplers[factor] != nullptr)
+        oversamplers[factor]->reset();
+}
+
+template <typename SampleType>
+int FeedbackSaturator<SampleType>::getLatencySamples() const
+{
+    const auto& oversampler = oversamplers[factor];
+    return oversampler != nullptr ? juce::roundToInt(oversampler->getLatencyInSamples()) : 0;
+}
+
+template <typename SampleType>
+void FeedbackSaturator<SampleType>::process(SampleType* const* channels, int numChannels, int startSample, int numSamples, int character)
+{
+    if (numSamples <= 0)
+        return;
+
+    auto& oversampler = oversamplers[factor];
+
+    if (oversampler == nullptr)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            Saturation::process(channels[channel] + startSample, numSamples, character);
+        return;
+    }
+
+    juce::dsp::AudioBlock<SampleType> block(channels, static_cast<size_t>(numChannels),
+                                       static_cast<size_t>(startSample), static_cast<size_t>(numSamples));
+    auto upsampled = oversampler->processSamplesUp(block);
+
+    for (size_t channel = 0; channel < upsampled.getNumChannels(); ++channel)
+        Saturation::process(upsampled.getChannelPointer(channel), static_cast<int>(upsampled.getNumSamples()), character);
+
+    oversampler->processSamplesDown(block);
+}
+
+template class FeedbackSaturator<float>;
+template class FeedbackSaturator<double>;
@@ -0,0 +1,44 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include "Saturation.h"
+
+//==============================================================================
+// Oversampling factors, shared by both sample precisions
+struct FeedbackSaturatorBase
+{
+    enum Factor { off = 0, x2, x4, x8, numFactors };
+
+    static juce::StringArray getFactorNames() { return { "Off", "2x", "4x", "8x" }; }
+};
+
+//==============================================================================
+// The saturation stage of the delay feedback path, optionally oversampled.
+//
+// Only the nonlinearity runs at the higher rate: each span is upsampled with
+// polyphase IIR half-band filters, saturated, and filtered back down, so the
+// harmonics it generates above the base Nyquist are removed instead of
+// aliasing. One oversampler per factor is built in prepare(), so switching
+// factors on the audio thread never allocates.
+//==============================================================================
+template <typename SampleType>
+class FeedbackSaturator : public FeedbackSaturatorBase
+{
+public:
+    void prepare (int numChannels, int maxBlockSize);
+    void reset();
+
+    // Selects the oversampling factor; a newly selected oversampler starts from silence
+    void setFactor (int newFactor);
+
+    // Whole-sample delay the current factor adds to the saturated signal
+    int getLatencySamples() const;
+
+    // Saturates channels[ch][startSample .. startSample + numSamples) in place
+    void process (SampleType* const* channels, int numChannels, int startSample, int numSamples, int character);
+
+private:
+    std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, numFactors> oversamplers; // [off] stays empty
+    int factor = off;
+};
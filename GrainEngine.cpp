@@ -0,0 +1,278 @@
+#include "GrainEngine.h"
+
+void GrainWindowTable::build()
+{
+    const float pi = juce::MathConstants<float>::pi;
+
+    for (int i = 0; i <= tableSize; ++i)
+    {
+        const float x = static_cast<float>(i) / tableSize;
+
+        // Hann
+        tables[hann][i] = 0.5f * (1.0f - std::cos(2.0f * pi * x));
+
+        // Tukey, cosine tapers over the outer 25% on each side
+        const float taper = 0.25f;
+        const float edge = juce::jmin(x, 1.0f - x);
+        tables[tukey][i] = edge < taper ? 0.5f * (1.0f - std::cos(pi * edge / taper)) : 1.0f;
+
+        // Gaussian, shifted so both ends land on zero
+        const float sigma = 0.15f;
+        const float gaussEnd = std::exp(-0.5f * (0.5f / sigma) * (0.5f / sigma));
+        const float gauss = std::exp(-0.5f * ((x - 0.5f) / sigma) * ((x - 0.5f) / sigma));
+        tables[gaussian][i] = (gauss - gaussEnd) / (1.0f - gaussEnd);
+
+        // Trapezoid, linear ramps over the outer 20% on each side
+        tables[trapezoid][i] = juce::jmin(1.0f, edge / 0.2f);
+
+        // Exponential decay with a short linear attack
+        const float attack = 0.02f;
+        const float decayEnd = std::exp(-6.0f);
+        tables[expDecay][i] = x < attack ? x / attack
+                                         : (std::exp(-6.0f * (x - attack) / (1.0f - attack)) - decayEnd) / (1.0f - decayEnd);
+    }
+}
+
+template <typename SampleType>
+void GrainEngine<SampleType>::prepare(SampleType* envelopeScratch, SampleType* gatherScratch, const GrainWindowTable& windowTable, int maxGrains)
+{
+    windows = &windowTable;
+    envelope = envelopeScratch;
+    gathered = gatherScratch;
+
+    startPos.assign(maxGrains, 0);
+    size.assign(maxGrains, 0);
+    position.assign(maxGrains, 0);
+    window.assign(maxGrains, GrainWindowTable::hann);
+    amplitude.assign(maxGrains, 1.0f);
+    rate.assign(maxGrains, 1.0f);
+    isReverse.assign(maxGrains, 0);
+
+    freeSlots.reserve(maxGrains);
+    activeSlots.reserve(maxGrains);
+    grainLimit = maxGrains;
+    reset();
+}
+
+template <typename SampleType>
+void GrainEngine<SampleType>::reset()
+{
+    activeSlots.clear();
+    freeSlots.clear();
+
+    // Push in reverse so slot 0 is handed out first
+    for (int slot = static_cast<int>(startPos.size()) - 1; slot >= 0; --slot)
+        freeSlots.push_back(slot);
+}
+
+template <typename SampleType>
+void GrainEngine<SampleType>::startGrain(int grainStart, int grainSize, bool reverse, float grainAmplitude, int grainWindow, int delay, float grainRate)
+{
+    if (!hasFreeSlot())
+        return;
+
+    const int slot = freeSlots.back();
+    freeSlots.pop_back();
+
+    startPos[slot] = grainStart;
+    size[slot] = grainSize;
+    position[slot] = -delay;
+    isReverse[slot] = reverse ? 1 : 0;
+    amplitude[slot] = grainAmplitude;
+    window[slot] = grainWindow;
+    rate[slot] = grainRate;
+
+    activeSlots.push_back(slot);
+}
+
+template <typename SampleType>
+int GrainEngine<SampleType>::getSafeRunLength(int writeIndex, int ringMask, int maxLength) const
+{
+    int length = maxLength;
+
+    for (const int slot : activeSlots)
+    {
+        const int played = juce::jmax(0, position[slot]);
+        const float grainRate = rate[slot];
+
+        if (grainRate != 1.0f)
+        {
+            // A read head moving at grainRate, plus the interpolator's next
+            // sample. It collides once it reaches a slot the head has written.
+            if (isReverse[slot])
+            {
+                const int readPos = static_cast<int>(startPos[slot] + (size[slot] - played) * static_cast<double>(grainRate)) & ringMask;
+                const int ahead = (readPos - writeIndex) & ringMask;
+                if (ahead > 0)
+                    length = juce::jmin(length, static_cast<int>(ahead / (1.0f + grainRate)) + 1);
+            }
+            else
+            {
+                const int readPos = static_cast<int>(startPos[slot] + played * static_cast<double>(grainRate)) & ringMask;
+                const int lag = (writeIndex - readPos) & ringMask;
+                if (lag > 0)
+                    length = juce::jmin(length, static_cast<int>(std::ceil((lag - 1) / grainRate)));
+
+                // Slowed-down grains ahead of the head get caught up with
+                const int ahead = (readPos - writeIndex) & ringMask;
+                if (grainRate < 1.0f)
+                    length = juce::jmin(length, static_cast<int>(ahead / (1.0f - grainRate)) + 1);
+            }
+        }
+        else if (isReverse[slot])
+        {
+            // Reverse grains walk towards older samples while the write head moves
+            // forward, so they only collide if they start ahead of the head.
+            const int readPos = (startPos[slot] + size[slot] - played) & ringMask;
+            const int ahead = (readPos - writeIndex) & ringMask;
+            if (ahead > 0)
+                length = juce::jmin(length, (ahead + 2) / 2);
+        }
+        else
+        {
+            // Forward grains keep a constant lag behind the write head
+            const int readPos = (startPos[slot] + played) & ringMask;
+            const int lag = (writeIndex - readPos) & ringMask;
+            if (lag > 0)
+                length = juce::jmin(length, lag);
+        }
+    }
+
+    return juce::jmax(1, length);
+}
+
+template <typename SampleType>
+int GrainEngine<SampleType>::getReadPositions(int* dest, int maxPositions, int ringMask) const
+{
+    int count = 0;
+
+    for (const int slot : activeSlots)
+    {
+        if (count >= maxPositions)
+            break;
+        if (position[slot] < 0)
+            continue; // scheduled but not started
+
+        const double travelled = (isReverse[slot] ? size[slot] - position[slot] : position[slot]) * static_cast<double>(rate[slot]);
+        dest[count++] = static_cast<int>(startPos[slot] + travelled) & ringMask;
+    }
+
+    return count;
+}
+
+template <typename SampleType>
+void GrainEngine<SampleType>::render(const SampleType* ring, int ringMask, SampleType* output, int numSamples)
+{
+    const int ringSize = ringMask + 1;
+
+    for (size_t i = 0; i < activeSlots.size();)
+    {
+        const int slot = activeSlots[i];
+
+        // Grains scheduled part-way into this run start at their onset offset
+        const int offset = juce::jmax(0, -position[slot]);
+        if (offset >= numSamples)
+        {
+            position[slot] += numSamples;
+            ++i;
+            continue;
+        }
+
+        position[slot] += offset;
+        const int count = juce::jmin(numSamples - offset, size[slot] - position[slot]);
+        SampleType* dest = output + offset;
+        fillEnvelope(slot, count);
+
+        if (rate[slot] != 1.0f)
+        {
+            gatherResampled(ring, ringMask, slot, count);
+            juce::FloatVectorOperations::addWithMultiply(dest, gathered, envelope, count);
+        }
+        else if (isReverse[slot])
+        {
+            gatherReversed(ring, ringSize, (startPos[slot] + size[slot] - position[slot]) & ringMask, count);
+            juce::FloatVectorOperations::addWithMultiply(dest, gathered, envelope, count);
+        }
+        else
+        {
+            // Split the forward read into wrap-free spans
+            const int readPos = (startPos[slot] + position[slot]) & ringMask;
+            const int first = juce::jmin(count, ringSize - readPos);
+            juce::FloatVectorOperations::addWithMultiply(dest, ring + readPos, envelope, first);
+            if (count > first)
+                juce::FloatVectorOperations::addWithMultiply(dest + first, ring, envelope + first, count - first);
+        }
+
+        position[slot] += count;
+
+        if (position[slot] >= size[slot])
+        {
+            // Finished: swap-remove from the active list and recycle the slot
+            activeSlots[i] = activeSlots.back();
+            activeSlots.pop_back();
+            freeSlots.push_back(slot);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+template <typename SampleType>
+void GrainEngine<SampleType>::fillEnvelope(int slot, int numSamples)
+{
+    // Interpolated table read, scaled by the grain amplitude
+    const float* table = windows->getTable(window[slot]);
+    const float increment = static_cast<float>(GrainWindowTable::tableSize) / juce::jmax(1, size[slot]);
+    const float gain = amplitude[slot];
+    const int start = position[slot];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float tablePos = (start + i) * increment;
+        const int index = static_cast<int>(tablePos);
+        const float fraction = tablePos - index;
+        envelope[i] = static_cast<SampleType>(gain * (table[index] + fraction * (table[index + 1] - table[index])));
+    }
+}
+
+template <typename SampleType>
+void GrainEngine<SampleType>::gatherReversed(const SampleType* ring, int ringSize, int readPos, int numSamples)
+{
+    // gathered[i] = ring[readPos - i], split into wrap-free spans
+    const int first = juce::jmin(numSamples, readPos + 1);
+    std::reverse_copy(ring + readPos - first + 1, ring + readPos + 1, gathered);
+
+    if (numSamples > first)
+    {
+        const int second = numSamples - first;
+        std::reverse_copy(ring + ringSize - second, ring + ringSize, gathered + first);
+    }
+}
+
+template <typename SampleType>
+void GrainEngine<SampleType>::gatherResampled(const SampleType* ring, int ringMask, int slot, int numSamples)
+{
+    // gathered[i] = ring at (position + i) * rate ring samples into the grain
+    // (counted back from its end when reversed), linearly interpolated. The
+    // offset is kept in double so long grains stay sample-accurate.
+    const double grainRate = rate[slot];
+    const double origin = isReverse[slot] ? startPos[slot] + size[slot] * grainRate : startPos[slot];
+    const double direction = isReverse[slot] ? -grainRate : grainRate;
+    const int start = position[slot];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double readPos = origin + (start + i) * direction;
+        const double floorPos = std::floor(readPos);
+        const int index = static_cast<int>(floorPos);
+        const SampleType fraction = static_cast<SampleType>(readPos - floorPos);
+        const SampleType a = ring[index & ringMask];
+        const SampleType b = ring[(index + 1) & ringMask];
+        gathered[i] = a + fraction * (b - a);
+    }
+}
+
+template class GrainEngine<float>;
+template class GrainEngine<double>;
@@ -0,0 +1,98 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+// Grain envelope lookup tables, one row per window shape. Built once in
+// prepareToPlay and shared by every GrainEngine.
+//==============================================================================
+class GrainWindowTable
+{
+public:
+    enum Shape { hann = 0, tukey, gaussian, trapezoid, expDecay, numShapes };
+
+    static constexpr int tableSize = 2048; // points across one grain, plus a guard point
+
+    void build();
+    const float* getTable (int shape) const { return tables[juce::jlimit (0, numShapes - 1, shape)].data(); }
+
+    static juce::StringArray getShapeNames() { return { "Hann", "Tukey", "Gaussian", "Trapezoid", "Exp Decay" }; }
+
+private:
+    std::array<std::array<float, tableSize + 1>, numShapes> tables {};
+};
+
+//==============================================================================
+// Block-based grain renderer for one channel.
+//
+// Grains read from the channel's delay ring buffer, whose length must be a
+// power of two; positions wrap with ringMask (= length - 1). Instead of walking every
+// slot once per sample, each active grain is rendered across a whole run of
+// samples: the envelope is generated for the run, the read region is split into
+// at most two wrap-free spans and the result is accumulated with vector ops.
+// Grains with a playback rate other than 1 read the ring through a linear
+// interpolator instead, in the same pass. The ring, output and scratch are
+// in the processing precision; grain timing and amplitudes are not.
+//==============================================================================
+template <typename SampleType>
+class GrainEngine
+{
+public:
+    static constexpr int defaultMaxGrains = 32;
+
+    // Allocates the grain pool; call from prepareToPlay. The two scratch buffers
+    // must each hold the longest run passed to render(). Engines that render one
+    // after another may share them.
+    void prepare (SampleType* envelopeScratch, SampleType* gatherScratch, const GrainWindowTable& windowTable, int maxGrains = defaultMaxGrains);
+    void reset();
+
+    // Caps how many pool slots may play at once (never more than the pool size)
+    void setGrainLimit (int limit) { grainLimit = juce::jlimit (0, static_cast<int> (startPos.size()), limit); }
+
+    bool hasFreeSlot() const { return ! freeSlots.empty() && getNumActiveGrains() < grainLimit; }
+    int getNumActiveGrains() const { return static_cast<int> (activeSlots.size()); }
+
+    // delay = samples into the next render() call before the grain starts playing.
+    // rate = ring samples read per output sample; the grain covers size * rate
+    // ring samples from startPos.
+    void startGrain (int startPos, int size, bool reverse, float amplitude, int window, int delay = 0, float rate = 1.0f);
+
+    // Longest run (<= maxLength) that can be rendered before any active grain
+    // would read a ring slot that the feedback loop writes during that run.
+    int getSafeRunLength (int writeIndex, int ringMask, int maxLength) const;
+
+    // Ring slot each playing grain reads next, for display. Fills at most
+    // maxPositions entries of dest and returns how many.
+    int getReadPositions (int* dest, int maxPositions, int ringMask) const;
+
+    // Adds numSamples of every active grain into output and advances them
+    void render (const SampleType* ring, int ringMask, SampleType* output, int numSamples);
+
+private:
+    const GrainWindowTable* windows = nullptr;
+
+    // Grain state in structure-of-arrays form, indexed by pool slot
+    std::vector<int>   startPos;
+    std::vector<int>   size;
+    std::vector<int>   position;
+    std::vector<int>   window;
+    std::vector<float> amplitude;
+    std::vector<float> rate;
+    std::vector<uint8_t> isReverse;
+
+    // Free slots are a stack, playing slots a compact list, so nothing scans
+    // idle grains. Both are reserved to the pool size in prepare().
+    std::vector<int> freeSlots;
+    std::vector<int> activeSlots;
+    int grainLimit = defaultMaxGrains;
+
+    SampleType* envelope = nullptr;
+    SampleType* gathered = nullptr;
+
+    void fillEnvelope (int slot, int numSamples);
+    void gatherReversed (const SampleType* ring, int ringSize, int readPos, int numSamples);
+    void gatherResampled (const SampleType* ring, int ringMask, int slot, int numSamples);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GrainEngine)
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cstdint>
+#include "SpscQueue.h"
+
+//==============================================================================
+// One grain onset as the engine scheduled it, for the grain cloud display.
+//==============================================================================
+struct GrainEvent
+{
+    int startLag = 0;           // start position, in samples behind the write head at the onset
+    int size = 0;               // output samples the grain plays for
+    float amplitude = 0.0f;
+    uint8_t channel = 0;
+    bool isReverse = false;
+};
+
+// A dense swarm can start thousands of grains a second; past the capacity the
+// newest onsets are dropped rather than stalling the audio thread
+using GrainEventQueue = SpscQueue<GrainEvent, 4096>;
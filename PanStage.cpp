@@ -0,0 +1,84 @@
+#include "PanStage.h"
+
+void PanStage::prepare(double sampleRate, float* positionScratch)
+{
+    positions = positionScratch;
+    smoother.reset(sampleRate, 0.05);
+    reset();
+}
+
+void PanStage::reset()
+{
+    smoother.setCurrentAndTargetValue(0.0f); // Center pan
+}
+
+template <typename SampleType>
+void PanStage::process(SampleType* left, SampleType* right, int numSamples, float position, int mode,
+                       const float* modulation, float modulationAmount)
+{
+    smoother.setTargetValue(position);
+
+    if (!smoother.isSmoothing() && modulation == nullptr)
+    {
+        // === Settled: one set of gains for the whole block ===
+        const float pan = smoother.getCurrentValue();
+        smoother.skip(numSamples);
+
+        if (mode == monoFold)
+        {
+            // Equal power panning of the mono sum
+            const float panAngle = (pan + 1.0f) * 0.25f * juce::MathConstants<float>::pi;
+            const float leftGain = std::cos(panAngle);
+            const float rightGain = std::sin(panAngle);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const SampleType mixedSample = (left[i] + right[i]) * SampleType(0.5);
+                left[i] = mixedSample * leftGain;
+                right[i] = mixedSample * rightGain;
+            }
+        }
+        else
+        {
+            const float halfPi = juce::MathConstants<float>::halfPi;
+            juce::FloatVectorOperations::multiply(left, static_cast<SampleType>(pan > 0.0f ? std::cos(pan * halfPi) : 1.0f), numSamples);
+            juce::FloatVectorOperations::multiply(right, static_cast<SampleType>(pan < 0.0f ? std::cos(pan * halfPi) : 1.0f), numSamples);
+        }
+
+        return;
+    }
+
+    // === Ramping: per-sample positions, polynomial gains ===
+    for (int i = 0; i < numSamples; ++i)
+        positions[i] = smoother.getNextValue();
+
+    if (modulation != nullptr)
+    {
+        juce::FloatVectorOperations::addWithMultiply(positions, modulation, modulationAmount, numSamples);
+        juce::FloatVectorOperations::clip(positions, positions, -1.0f, 1.0f, numSamples);
+    }
+
+    if (mode == monoFold)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // angle (pan + 1) * pi / 4, i.e. x = (pan + 1) / 2 of a quarter turn
+            const float x = (positions[i] + 1.0f) * 0.5f;
+            const SampleType mixedSample = (left[i] + right[i]) * SampleType(0.5);
+            left[i] = mixedSample * quarterSine(1.0f - x);
+            right[i] = mixedSample * quarterSine(x);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float pan = positions[i];
+            left[i] *= quarterSine(1.0f - juce::jmax(0.0f, pan));
+            right[i] *= quarterSine(1.0f + juce::jmin(0.0f, pan));
+        }
+    }
+}
+
+template void PanStage::process<float>(float*, float*, int, float, int, const float*, float);
+template void PanStage::process<double>(double*, double*, int, float, int, const float*, float);
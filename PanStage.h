@@ -0,0 +1,45 @@
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+// Stereo pan stage.
+//
+// monoFold is the original behaviour: both channels are summed and the mono
+// signal is placed with an equal-power law. balance keeps the stereo image
+// and only attenuates the side the position moves away from (unity at centre).
+//
+// While the position is settled the gains are computed once per block. While
+// it ramps (smoothing or LFO) the positions are written to a scratch buffer
+// and the gains come from a short polynomial, so both loops vectorise.
+// Positions and gains are control signals and stay in float; the samples
+// they scale are in the processing precision.
+//==============================================================================
+class PanStage
+{
+public:
+    enum Mode { monoFold = 0, balance, numModes };
+
+    static juce::StringArray getModeNames() { return { "Mono Fold", "Balance" }; }
+
+    // positionScratch must hold maxBlockSize floats
+    void prepare (double sampleRate, float* positionScratch);
+    void reset();
+
+    // position in -1..1. If modulation is non-null, modulation[i] * modulationAmount
+    // is added to the smoothed position per sample.
+    template <typename SampleType>
+    void process (SampleType* left, SampleType* right, int numSamples, float position, int mode,
+                  const float* modulation = nullptr, float modulationAmount = 0.0f);
+
+private:
+    juce::SmoothedValue<float> smoother;
+    float* positions = nullptr;
+
+    // sin(x * pi / 2) for x in 0..1, odd Taylor polynomial (error < 2e-4)
+    static float quarterSine (float x) noexcept
+    {
+        const float a = x * juce::MathConstants<float>::halfPi;
+        const float a2 = a * a;
+        return a * (1.0f + a2 * (-1.0f / 6.0f + a2 * (1.0f / 120.0f + a2 * (-1.0f / 5040.0f))));
+    }
+};
@@ -0,0 +1,224 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "GrainEngine.h"
+#include "FeedbackEq.h"
+#include "PanStage.h"
+#include "FeedbackSaturator.h"
+#include "PhaseVocoder.h"
+
+//==============================================================================
+// Every plugin parameter in one compile-time table. createParameterLayout()
+// builds the APVTS layout from it, and the processor resolves each entry's raw
+// value pointer once, so nothing on the audio thread looks a parameter up by
+// its string ID.
+//==============================================================================
+namespace Params
+{
+    // Table index of each parameter; the table below must list them in this order
+    enum ID
+    {
+        delayTime = 0, feedback, mix,
+        grainSize, grainDensity, grainSpray, reverseGrains, randomization, grainWindow, swarmMode, grainPitch, grainDetune,
+        stereoWidth, eqHigh, eqLow, eqSlope, saturation, oversampling,
+        filterEnabled, filterCutoff, filterResonance, filterType,
+        pitchSemitones, pitchOctaves, pitchMix, pitchMode, pitchFftSize, pitchOverlap,
+        panPosition, panMode,
+        lfoRate, lfoDepth, lfoTarget, lfoBipolar, lfoWaveform, lfoTempoSync, lfoSyncDivision,
+        chorusRate, chorusDepth, chorusMix,
+        flangerDelay, flangerFeedback, flangerDepth, flangerRate, flangerMix,
+        numParams
+    };
+
+    enum class Kind { floating, boolean, choice };
+
+    struct Spec
+    {
+        ID index;
+        const char* id;
+        const char* name;
+        Kind kind;
+        float minValue, maxValue, interval, skew; // floating only
+        float defaultValue;                       // 0/1 for boolean, item index for choice
+        juce::StringArray (*choices)();           // choice only
+    };
+
+    constexpr Spec floatParam (ID index, const char* id, const char* name,
+                               float minValue, float maxValue, float interval, float skew, float defaultValue)
+    {
+        return { index, id, name, Kind::floating, minValue, maxValue, interval, skew, defaultValue, nullptr };
+    }
+
+    constexpr Spec boolParam (ID index, const char* id, const char* name, bool defaultValue)
+    {
+        return { index, id, name, Kind::boolean, 0.0f, 1.0f, 1.0f, 1.0f, defaultValue ? 1.0f : 0.0f, nullptr };
+    }
+
+    constexpr Spec choiceParam (ID index, const char* id, const char* name, juce::StringArray (*choices)(), int defaultIndex)
+    {
+        return { index, id, name, Kind::choice, 0.0f, 0.0f, 1.0f, 1.0f, static_cast<float> (defaultIndex), choices };
+    }
+
+    inline constexpr std::array<Spec, numParams> table
+    {{
+        // === ORIGINAL PARAMETERS ===
+        floatParam (delayTime,       "delayTime",       "Delay Time (ms)",    1.f, 2000.f, 0.01f, 0.35f, 400.f),
+        floatParam (feedback,        "feedback",        "Feedback",           0.f, 0.95f, 0.001f, 0.5f, 0.35f),
+        floatParam (mix,             "mix",             "Mix (%)",            0.f, 100.f, 0.01f, 0.5f, 35.f),
+
+        floatParam (grainSize,       "grainSize",       "Grain Size (ms)",    5.f, 200.f, 0.01f, 0.5f, 60.f),
+        floatParam (grainDensity,    "grainDensity",    "Grain Density",      0.1f, 4.0f, 0.001f, 0.5f, 1.0f),
+        floatParam (grainSpray,      "grainSpray",      "Grain Spray (%)",    0.f, 100.f, 0.01f, 0.5f, 10.f),
+        boolParam  (reverseGrains,   "reverseGrains",   "Reverse Grains",     false),
+        floatParam (randomization,   "randomization",   "Randomization (%)",  0.f, 100.f, 0.01f, 0.5f, 15.f),
+        choiceParam(grainWindow,     "grainWindow",     "Grain Window",       &GrainWindowTable::getShapeNames, GrainWindowTable::hann),
+        boolParam  (swarmMode,       "swarmMode",       "Swarm Mode",         false),
+        floatParam (grainPitch,      "grainPitch",      "Grain Pitch",        -24.f, 24.f, 0.01f, 1.0f, 0.f),
+        boolParam  (grainDetune,     "grainDetune",     "Grain Detune",       false),
+
+        floatParam (stereoWidth,     "stereoWidth",     "Stereo Width (%)",   0.f, 100.f, 0.01f, 0.5f, 50.f),
+        floatParam (eqHigh,          "eqHigh",          "High Cut",           0.f, 100.f, 0.01f, 1.0f, 80.f),
+        floatParam (eqLow,           "eqLow",           "Low Cut",            0.f, 100.f, 0.01f, 1.0f, 10.f),
+        choiceParam(eqSlope,         "eqSlope",         "EQ Slope",           &FeedbackEqBase::getSlopeNames, FeedbackEqBase::slope6dB),
+        choiceParam(saturation,      "saturation",      "Saturation",         &Saturation::getCharacterNames, Saturation::knee),
+        choiceParam(oversampling,    "oversampling",    "Oversampling",       &FeedbackSaturatorBase::getFactorNames, FeedbackSaturatorBase::off),
+
+        // === NEW ADVANCED PARAMETERS ===
+        boolParam  (filterEnabled,   "filterEnabled",   "Filter Enabled",     false),
+        floatParam (filterCutoff,    "filterCutoff",    "Filter Cutoff",      0.f, 100.f, 0.01f, 0.3f, 70.f),
+        floatParam (filterResonance, "filterResonance", "Filter Resonance",   0.f, 100.f, 0.01f, 0.5f, 10.f),
+        floatParam (filterType,      "filterType",      "Filter Type",        0.f, 100.f, 1.f, 1.0f, 0.f), // 0-33=LP, 34-66=BP, 67-100=HP
+
+        floatParam (pitchSemitones,  "pitchSemitones",  "Pitch Semitones",    -12.f, 12.f, 0.01f, 1.0f, 0.f),
+        floatParam (pitchOctaves,    "pitchOctaves",    "Pitch Octaves",      -2.f, 2.f, 0.01f, 1.0f, 0.f),
+        floatParam (pitchMix,        "pitchMix",        "Pitch Mix",          0.f, 100.f, 0.01f, 1.0f, 50.f),
+        choiceParam(pitchMode,       "pitchMode",       "Pitch Mode",         &PhaseVocoder::getPitchModeNames, PhaseVocoder::timeDomain),
+        choiceParam(pitchFftSize,    "pitchFftSize",    "Pitch FFT Size",     &PhaseVocoder::getFftSizeNames, PhaseVocoder::fft2048),
+        choiceParam(pitchOverlap,    "pitchOverlap",    "Pitch Overlap",      &PhaseVocoder::getOverlapNames, PhaseVocoder::overlap4),
+
+        floatParam (panPosition,     "panPosition",     "Pan Position",       -100.f, 100.f, 0.01f, 1.0f, 0.f),
+        choiceParam(panMode,         "panMode",         "Pan Mode",           &PanStage::getModeNames, PanStage::balance),
+
+        floatParam (lfoRate,         "lfoRate",         "LFO Rate",           0.f, 100.f, 0.01f, 0.5f, 25.f),
+        floatParam (lfoDepth,        "lfoDepth",        "LFO Depth",          0.f, 100.f, 0.01f, 0.5f, 0.f),
+        floatParam (lfoTarget,       "lfoTarget",       "LFO Target",         0.f, 100.f, 1.f, 1.0f, 0.f),  // 0-50=Cutoff, 51-100=Pan
+        boolParam  (lfoBipolar,      "lfoBipolar",      "LFO Bipolar",        true),
+        floatParam (lfoWaveform,     "lfoWaveform",     "LFO Waveform",       0.f, 100.f, 1.f, 1.0f, 0.f),  // 0-50=Sine, 51-100=Triangle
+        boolParam  (lfoTempoSync,    "lfoTempoSync",    "LFO Tempo Sync",     false),
+        floatParam (lfoSyncDivision, "lfoSyncDivision", "LFO Sync Division",  0.f, 2.f, 1.f, 1.0f, 2.f),    // 0=1/4, 1=1/2, 2=1bar
+
+        floatParam (chorusRate,      "chorusRate",      "Chorus Rate",        0.f, 100.f, 0.01f, 0.5f, 50.f),
+        floatParam (chorusDepth,     "chorusDepth",     "Chorus Depth",       0.f, 100.f, 0.01f, 0.5f, 30.f),
+        floatParam (chorusMix,       "chorusMix",       "Chorus Mix",         0.f, 100.f, 0.01f, 0.5f, 0.f),
+
+        floatParam (flangerDelay,    "flangerDelay",    "Flanger Delay",      0.f, 100.f, 0.01f, 0.5f, 25.f),
+        floatParam (flangerFeedback, "flangerFeedback", "Flanger Feedback",   0.f, 95.f, 0.01f, 0.5f, 40.f),
+        floatParam (flangerDepth,    "flangerDepth",    "Flanger Depth",      0.f, 100.f, 0.01f, 0.5f, 60.f),
+        floatParam (flangerRate,     "flangerRate",     "Flanger Rate",       0.f, 100.f, 0.01f, 0.5f, 30.f),
+        floatParam (flangerMix,      "flangerMix",      "Flanger Mix",        0.f, 100.f, 0.01f, 0.5f, 0.f),
+    }};
+
+    constexpr bool isTableInOrder()
+    {
+        for (int i = 0; i < numParams; ++i)
+            if (table[(size_t) i].index != i)
+                return false;
+        return true;
+    }
+
+    static_assert (isTableInOrder(), "Params::table must list parameters in ID order");
+
+    // Sessions saved before a parameter existed load it at its default. Where
+    // that default would change how an old session sounds, the entry here
+    // gives the value that reproduces the old behaviour instead.
+    struct LegacyValue
+    {
+        ID index;
+        float value;
+    };
+
+    inline constexpr std::array<LegacyValue, 2> legacyValues
+    {{
+        { filterEnabled, 1.0f },
+        { panMode, static_cast<float> (PanStage::monoFold) },
+    }};
+}
+
+//==============================================================================
+// Typed, immutable copy of every parameter, taken once at the top of each
+// block. Values keep their parameter units unless noted.
+//==============================================================================
+struct ParamSnapshot
+{
+    enum FilterMode { lowpass = 0, bandpass, highpass };
+    enum LfoTarget { lfoToCutoff = 0, lfoToPan };
+    enum LfoWaveform { lfoSine = 0, lfoTriangle };
+
+    // Granular delay
+    float delayTimeMs = 400.0f;
+    float feedback = 0.35f;
+    float mix = 0.35f;              // 0..1
+    float grainSizeMs = 60.0f;
+    float grainDensity = 1.0f;
+    float grainSpray = 0.1f;        // 0..1
+    bool  reverseGrains = false;
+    float randomization = 0.15f;    // 0..1
+    int   grainWindow = GrainWindowTable::hann;
+    bool  swarmMode = false;
+    float grainPitch = 0.0f;        // semitones
+    bool  grainDetune = false;
+    float stereoWidth = 0.5f;       // 0..1
+    float eqHigh = 80.0f;
+    float eqLow = 10.0f;
+    int   eqSlope = FeedbackEqBase::slope6dB;
+    int   saturation = Saturation::knee;
+    int   oversampling = FeedbackSaturatorBase::off;
+
+    // Filter
+    bool  filterEnabled = false;
+    float filterCutoff = 70.0f;
+    float filterResonance = 10.0f;
+    FilterMode filterMode = lowpass;
+
+    // Filter parameter mappings, shared with the editor's response curve.
+    // The editor writes filterType as 0/50/100 for LP/BP/HP.
+    static float filterCutoffToHz (float cutoff)     { return juce::jmap (cutoff, 0.0f, 100.0f, 20.0f, 20000.0f); }
+    static float filterResonanceToQ (float resonance) { return juce::jmap (resonance, 0.0f, 100.0f, 0.5f, 10.0f); }
+    static FilterMode filterTypeToMode (float type)
+    {
+        return type <= 33.0f ? lowpass : type <= 66.0f ? bandpass : highpass;
+    }
+
+    // Pitch
+    float pitchSemitones = 0.0f;
+    float pitchOctaves = 0.0f;
+    float pitchMix = 0.5f;          // 0..1
+    int   pitchMode = PhaseVocoder::timeDomain;
+    int   pitchFftSize = PhaseVocoder::fft2048;
+    int   pitchOverlap = PhaseVocoder::overlap4;
+
+    // Pan
+    float panPosition = 0.0f;
+    int   panMode = PanStage::balance;
+
+    // LFO
+    float lfoRate = 25.0f;
+    float lfoDepth = 0.0f;
+    LfoTarget lfoTarget = lfoToCutoff;
+    bool  lfoBipolar = true;
+    LfoWaveform lfoWaveform = lfoSine;
+    bool  lfoTempoSync = false;
+    int   lfoSyncDivision = 2;
+
+    // Chorus
+    float chorusRate = 50.0f;
+    float chorusDepth = 30.0f;
+    float chorusMix = 0.0f;         // 0..1
+
+    // Flanger
+    float flangerDelay = 25.0f;
+    float flangerFeedback = 40.0f;
+    float flangerDepth = 60.0f;
+    float flangerRate = 30.0f;
+    float flangerMix = 0.0f;        // 0..1
+};
@@ -0,0 +1,207 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+// Min / max summary of the delay rings at several decimation levels, so the
+// editor can draw the whole delay memory at any zoom without touching raw
+// samples.
+//
+// The audio thread folds every run it writes into the ring into the finest
+// level and refreshes the coarser bins above it, so the cost follows the
+// number of samples written, not the ring size. All channels share one
+// summary. A bin starts over when the write head enters it, so the older
+// samples still in that bin drop out of the picture up to one fine bin early.
+//
+// Bins, the write head and the grain markers are relaxed atomics in storage
+// allocated once in the constructor: the editor may see a frame that is part
+// old and part new, but never freed memory, even across prepareToPlay.
+//==============================================================================
+class PeakPyramid
+{
+public:
+    static constexpr int numLevels = 3;
+    static constexpr int levelRatioBits = 3;          // each level bins 8 of the one below
+    static constexpr int finestBinBits = 6;           // 64, 512 and 4096 samples per bin
+    static constexpr int maxFinestBins = 1 << 14;     // covers rings up to 2^20 samples
+    static constexpr int maxGrainMarkers = 64;
+
+    PeakPyramid()
+    {
+        for (int level = 0; level < numLevels; ++level)
+            levels[(size_t) level] = std::vector<Bin> ((size_t) (maxFinestBins >> (level * levelRatioBits)));
+    }
+
+    // Call from prepareToPlay with the (power of two) ring size. Rings too big
+    // for the fixed storage get proportionally wider bins.
+    void prepare (int newRingSize) noexcept
+    {
+        jassert (juce::isPowerOfTwo (newRingSize));
+
+        int shift = finestBinBits;
+        while ((newRingSize >> shift) > maxFinestBins)
+            ++shift;
+
+        // The ring must hold at least one whole coarsest bin
+        jassert (newRingSize >= 1 << (shift + (numLevels - 1) * levelRatioBits));
+        ringSize = newRingSize;
+        binShift.store (shift, std::memory_order_relaxed);
+        ringSizeForReader.store (newRingSize, std::memory_order_relaxed);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& level : levels)
+            for (auto& bin : level)
+            {
+                bin.min.store (0.0f, std::memory_order_relaxed);
+                bin.max.store (0.0f, std::memory_order_relaxed);
+            }
+
+        writeHead.store (0, std::memory_order_relaxed);
+        numGrainMarkers.store (0, std::memory_order_relaxed);
+    }
+
+    // Audio thread. Folds ring slots [start, start + numSamples) of every
+    // channel into the summary, right after they were written. memory holds
+    // the channels' rings back to back.
+    template <typename SampleType>
+    void write (const SampleType* memory, int numChannels, int start, int numSamples) noexcept
+    {
+        if (numChannels <= 0 || ringSize == 0)
+            return;
+
+        const int shift = binShift.load (std::memory_order_relaxed);
+        const int binSize = 1 << shift;
+        int pos = start;
+
+        // Ring ends fall on bin boundaries, so a bin never spans the wrap
+        while (numSamples > 0)
+        {
+            const int offset = pos & (binSize - 1);
+            const int length = juce::jmin (numSamples, binSize - offset);
+
+            auto range = juce::FloatVectorOperations::findMinAndMax (memory + pos, length);
+            for (int channel = 1; channel < numChannels; ++channel)
+                range = range.getUnionWith (juce::FloatVectorOperations::findMinAndMax (memory + (size_t) channel * (size_t) ringSize + pos, length));
+
+            auto lo = static_cast<float> (range.getStart());
+            auto hi = static_cast<float> (range.getEnd());
+            auto& bin = levels[0][(size_t) (pos >> shift)];
+
+            if (offset > 0)
+            {
+                lo = juce::jmin (lo, bin.min.load (std::memory_order_relaxed));
+                hi = juce::jmax (hi, bin.max.load (std::memory_order_relaxed));
+            }
+
+            bin.min.store (lo, std::memory_order_relaxed);
+            bin.max.store (hi, std::memory_order_relaxed);
+
+            int index = pos >> shift;
+            for (int level = 1; level < numLevels; ++level)
+            {
+                index >>= levelRatioBits;
+                refreshParent (level, index);
+            }
+
+            pos = (pos + length) & (ringSize - 1);
+            numSamples -= length;
+        }
+    }
+
+    // Audio thread, once per block: where the next sample will be written and
+    // which ring slots the playing grains are reading.
+    void publishPositions (int newWriteHead, const int* grainPositions, int numGrains) noexcept
+    {
+        numGrains = juce::jmin (numGrains, maxGrainMarkers);
+        for (int i = 0; i < numGrains; ++i)
+            grainMarkers[(size_t) i].store (grainPositions[i], std::memory_order_relaxed);
+
+        numGrainMarkers.store (numGrains, std::memory_order_relaxed);
+        writeHead.store (newWriteHead, std::memory_order_relaxed);
+    }
+
+    // Message thread. Peak range of ring slots [start, start + numSamples),
+    // read from the coarsest level whose bins still fit inside the span.
+    juce::Range<float> getRange (int start, int numSamples) const noexcept
+    {
+        const int size = getRingSize();
+        if (size == 0 || numSamples <= 0)
+            return {};
+
+        int level = 0;
+        int shift = binShift.load (std::memory_order_relaxed);
+        while (level + 1 < numLevels && (1 << (shift + levelRatioBits)) <= numSamples)
+        {
+            ++level;
+            shift += levelRatioBits;
+        }
+
+        const auto& bins = levels[(size_t) level];
+        // min() keeps the index in bounds if prepare() is changing the shift
+        const int binMask = juce::jmin (size >> shift, static_cast<int> (bins.size())) - 1;
+        const int first = (start & (size - 1)) >> shift;
+        const int count = juce::jmin (binMask + 1, ((numSamples - 1) >> shift) + 1);
+
+        float lo = bins[(size_t) first].min.load (std::memory_order_relaxed);
+        float hi = bins[(size_t) first].max.load (std::memory_order_relaxed);
+        for (int i = 1; i < count; ++i)
+        {
+            const auto& bin = bins[(size_t) ((first + i) & binMask)];
+            lo = juce::jmin (lo, bin.min.load (std::memory_order_relaxed));
+            hi = juce::jmax (hi, bin.max.load (std::memory_order_relaxed));
+        }
+
+        return { lo, hi };
+    }
+
+    int getRingSize() const noexcept   { return ringSizeForReader.load (std::memory_order_relaxed); }
+    int getWriteHead() const noexcept  { return writeHead.load (std::memory_order_relaxed); }
+
+    // Copies up to maxPositions grain read positions into dest and returns how many
+    int getGrainPositions (int* dest, int maxPositions) const noexcept
+    {
+        const int count = juce::jmin (maxPositions, numGrainMarkers.load (std::memory_order_relaxed));
+        for (int i = 0; i < count; ++i)
+            dest[i] = grainMarkers[(size_t) i].load (std::memory_order_relaxed);
+        return count;
+    }
+
+private:
+    struct Bin
+    {
+        std::atomic<float> min { 0.0f }, max { 0.0f };
+    };
+
+    // Recomputes one bin from the bins it covers on the level below
+    void refreshParent (int level, int index) noexcept
+    {
+        const auto& children = levels[(size_t) (level - 1)];
+        const int firstChild = index << levelRatioBits;
+        float lo = children[(size_t) firstChild].min.load (std::memory_order_relaxed);
+        float hi = children[(size_t) firstChild].max.load (std::memory_order_relaxed);
+
+        for (int i = 1; i < (1 << levelRatioBits); ++i)
+        {
+            lo = juce::jmin (lo, children[(size_t) (firstChild + i)].min.load (std::memory_order_relaxed));
+            hi = juce::jmax (hi, children[(size_t) (firstChild + i)].max.load (std::memory_order_relaxed));
+        }
+
+        auto& bin = levels[(size_t) level][(size_t) index];
+        bin.min.store (lo, std::memory_order_relaxed);
+        bin.max.store (hi, std::memory_order_relaxed);
+    }
+
+    std::array<std::vector<Bin>, numLevels> levels;
+    int ringSize = 0; // the audio thread's copy
+
+    std::atomic<int> binShift { finestBinBits };
+    std::atomic<int> ringSizeForReader { 0 };
+    std::atomic<int> writeHead { 0 };
+    std::atomic<int> numGrainMarkers { 0 };
+    std::array<std::atomic<int>, maxGrainMarkers> grainMarkers {};
+};
@@ -0,0 +1,193 @@
+#include "PhaseVocoder.h"
+
+namespace
+{
+    constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+    // Wraps a phase to [-pi, pi]
+    inline float wrapPhase(float phase) noexcept
+    {
+        return phase - twoPi * std::floor(phase / twoPi + 0.5f);
+    }
+}
+
+void PhaseVocoder::prepare(int numChannels)
+{
+    for (int i = 0; i < numFftSizes; ++i)
+    {
+        const int size = 1 << (minOrder + i);
+        ffts[(size_t) i] = std::make_unique<juce::dsp::FFT>(minOrder + i);
+
+        // Periodic Hann, used for both analysis and synthesis
+        auto& window = windows[(size_t) i];
+        window.resize((size_t) size);
+        for (int n = 0; n < size; ++n)
+            window[(size_t) n] = 0.5f - 0.5f * std::cos(twoPi * static_cast<float>(n) / static_cast<float>(size));
+    }
+
+    channelMemory.assign(static_cast<size_t>(numChannels * floatsPerChannel), 0.0f);
+    channelState.resize(static_cast<size_t>(numChannels));
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        auto& channel = channelState[(size_t) i];
+        channel.inputFifo = channelMemory.data() + i * floatsPerChannel;
+        channel.outputFifo = channel.inputFifo + maxFrameSize;
+        channel.outputAccumulator = channel.outputFifo + maxFrameSize;
+        channel.lastPhase = channel.outputAccumulator + 2 * maxFrameSize;
+        channel.phaseSum = channel.lastPhase + maxBins;
+    }
+
+    fftData.assign(2 * maxFrameSize, 0.0f);
+    magnitudes.assign(maxBins, 0.0f);
+    frequencies.assign(maxBins, 0.0f);
+    shiftedMagnitudes.assign(maxBins, 0.0f);
+    shiftedFrequencies.assign(maxBins, 0.0f);
+
+    clearState();
+}
+
+void PhaseVocoder::reset()
+{
+    clearState();
+}
+
+void PhaseVocoder::setConfiguration(int fftSize, int overlap)
+{
+    const int newSizeIndex = juce::jlimit(0, numFftSizes - 1, fftSize);
+    const int newOverlapFactor = overlap == overlap8 ? 8 : 4;
+
+    if (newSizeIndex == sizeIndex && newOverlapFactor == overlapFactor)
+        return;
+
+    sizeIndex = newSizeIndex;
+    overlapFactor = newOverlapFactor;
+    frameSize = 1 << (minOrder + sizeIndex);
+    hopSize = frameSize / overlapFactor;
+    clearState();
+}
+
+void PhaseVocoder::clearState()
+{
+    std::fill(channelMemory.begin(), channelMemory.end(), 0.0f);
+    fifoPosition = getLatencySamples();
+    isShifting = false;
+}
+
+void PhaseVocoder::clearSynthesis(Channel& channel)
+{
+    // Everything after the input fifo
+    std::fill(channel.outputFifo, channel.inputFifo + floatsPerChannel, 0.0f);
+}
+
+void PhaseVocoder::process(float* const* channels, int channelsToProcess, int numSamples, float ratio, float mix)
+{
+    const bool shouldShift = ratio != 1.0f && mix > 0.0f;
+
+    // Resynthesis restarts from fresh phases; the input history is kept
+    if (shouldShift && !isShifting)
+    {
+        for (auto& channel : channelState)
+            clearSynthesis(channel);
+    }
+
+    isShifting = shouldShift;
+
+    const int latency = getLatencySamples();
+    channelsToProcess = juce::jmin(channelsToProcess, static_cast<int>(channelState.size()));
+    int position = fifoPosition;
+
+    for (int channel = 0; channel < channelsToProcess; ++channel)
+    {
+        auto& state = channelState[(size_t) channel];
+        auto* data = channels[channel];
+        position = fifoPosition;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            state.inputFifo[(size_t) position] = data[i];
+
+            const float dry = state.inputFifo[(size_t) (position - latency)];
+            const float wet = state.outputFifo[(size_t) (position - latency)];
+            data[i] = isShifting ? dry + (wet - dry) * mix : dry;
+
+            if (++position >= frameSize)
+            {
+                position = latency;
+
+                if (isShifting)
+                    processFrame(state, ratio);
+
+                std::copy(state.inputFifo + hopSize, state.inputFifo + frameSize, state.inputFifo);
+            }
+        }
+    }
+
+    fifoPosition = position;
+}
+
+void PhaseVocoder::processFrame(Channel& state, float ratio)
+{
+    const int numBins = frameSize / 2 + 1;
+    const float* window = windows[(size_t) sizeIndex].data();
+    const float expectedAdvance = twoPi * static_cast<float>(hopSize) / static_cast<float>(frameSize);
+    const float overlap = static_cast<float>(overlapFactor);
+    float* frame = fftData.data();
+
+    // === ANALYSIS ===
+    juce::FloatVectorOperations::multiply(frame, state.inputFifo, window, frameSize);
+    ffts[(size_t) sizeIndex]->performRealOnlyForwardTransform(frame, true);
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const float re = frame[2 * k];
+        const float im = frame[2 * k + 1];
+        const float phase = std::atan2(im, re);
+
+        // Deviation from the bin centre's phase advance gives the true frequency
+        const float deviation = wrapPhase(phase - state.lastPhase[(size_t) k] - static_cast<float>(k) * expectedAdvance);
+        state.lastPhase[(size_t) k] = phase;
+
+        magnitudes[(size_t) k] = std::sqrt(re * re + im * im);
+        frequencies[(size_t) k] = static_cast<float>(k) + deviation * overlap / twoPi; // in bins
+    }
+
+    // === SHIFT ===
+    std::fill(shiftedMagnitudes.begin(), shiftedMagnitudes.begin() + numBins, 0.0f);
+    std::fill(shiftedFrequencies.begin(), shiftedFrequencies.begin() + numBins, 0.0f);
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const int target = static_cast<int>(static_cast<float>(k) * ratio);
+        if (target >= numBins)
+            break;
+
+        shiftedMagnitudes[(size_t) target] += magnitudes[(size_t) k];
+        shiftedFrequencies[(size_t) target] = frequencies[(size_t) k] * ratio;
+    }
+
+    // === SYNTHESIS ===
+    for (int k = 0; k < numBins; ++k)
+    {
+        const float advance = (shiftedFrequencies[(size_t) k] - static_cast<float>(k)) * twoPi / overlap
+                            + static_cast<float>(k) * expectedAdvance;
+        const float phase = wrapPhase(state.phaseSum[(size_t) k] + advance);
+        state.phaseSum[(size_t) k] = phase;
+
+        frame[2 * k] = shiftedMagnitudes[(size_t) k] * std::cos(phase);
+        frame[2 * k + 1] = shiftedMagnitudes[(size_t) k] * std::sin(phase);
+    }
+
+    std::fill(frame + 2 * numBins, frame + 2 * frameSize, 0.0f);
+    ffts[(size_t) sizeIndex]->performRealOnlyInverseTransform(frame);
+
+    // Hann analysis x Hann synthesis overlaps to 3/8 of the overlap factor
+    const float gain = 1.0f / (0.375f * overlap);
+    auto* accumulator = state.outputAccumulator;
+
+    for (int n = 0; n < frameSize; ++n)
+        accumulator[n] += frame[n] * window[n] * gain;
+
+    std::copy(accumulator, accumulator + hopSize, state.outputFifo);
+    std::copy(accumulator + hopSize, accumulator + hopSize + frameSize, accumulator);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+// STFT phase-vocoder pitch shifter for polyphonic material.
+//
+// Each hop, a Hann-windowed frame is analysed into per-bin magnitudes and
+// true frequencies, the bins are moved by the pitch ratio, and the frame is
+// resynthesised with accumulated phases and overlap-added back. The output
+// (and the dry signal it is blended with) is delayed by fftSize - hop.
+//
+// Frame buffers and FFT plans for every size are allocated in prepare(), so
+// changing size or overlap on the audio thread only clears state.
+//==============================================================================
+class PhaseVocoder
+{
+public:
+    enum PitchMode { timeDomain = 0, spectral, numPitchModes };
+    enum FftSize { fft512 = 0, fft1024, fft2048, fft4096, numFftSizes };
+    enum Overlap { overlap4 = 0, overlap8, numOverlaps };
+
+    static juce::StringArray getPitchModeNames() { return { "Delay Line", "Phase Vocoder" }; }
+    static juce::StringArray getFftSizeNames()   { return { "512", "1024", "2048", "4096" }; }
+    static juce::StringArray getOverlapNames()   { return { "4x", "8x" }; }
+
+    void prepare (int numChannels);
+    void reset();
+
+    // Takes effect immediately and restarts from silence when anything changed
+    void setConfiguration (int fftSize, int overlap);
+
+    int getLatencySamples() const noexcept { return frameSize - hopSize; }
+
+    // The latency setConfiguration (fftSize, overlap) would give
+    static int getLatencySamples (int fftSize, int overlap) noexcept
+    {
+        const int size = 1 << (minOrder + juce::jlimit (0, numFftSizes - 1, fftSize));
+        return size - size / (overlap == overlap8 ? 8 : 4);
+    }
+
+    // ratio = output/input frequency, mix = 0..1 shifted signal against the
+    // delayed input. With ratio == 1 or mix == 0 no frames are analysed and the
+    // output is just the delayed input.
+    // Channels beyond the prepared count pass through undelayed.
+    void process (float* const* channels, int channelsToProcess, int numSamples, float ratio, float mix);
+
+private:
+    static constexpr int minOrder = 9;
+    static constexpr int maxFrameSize = 1 << (minOrder + numFftSizes - 1);
+    static constexpr int maxBins = maxFrameSize / 2 + 1;
+
+    // Views into channelMemory, which holds every channel's state back to back
+    struct Channel
+    {
+        float* inputFifo;         // maxFrameSize
+        float* outputFifo;        // maxFrameSize
+        float* outputAccumulator; // 2 * maxFrameSize
+        float* lastPhase;         // maxBins
+        float* phaseSum;          // maxBins
+    };
+
+    static constexpr int floatsPerChannel = 4 * maxFrameSize + 2 * maxBins;
+
+    void processFrame (Channel& channel, float ratio);
+    void clearState();
+    void clearSynthesis (Channel& channel);
+
+    std::array<std::unique_ptr<juce::dsp::FFT>, numFftSizes> ffts;
+    std::array<std::vector<float>, numFftSizes> windows;
+    std::vector<float> channelMemory;
+    std::vector<Channel> channelState;
+
+    // Per-frame working buffers, shared by the channels
+    std::vector<float> fftData, magnitudes, frequencies, shiftedMagnitudes, shiftedFrequencies;
+
+    int sizeIndex = fft2048;
+    int frameSize = 2048, hopSize = 512, overlapFactor = 4;
+    int fifoPosition = 0;
+    bool isShifting = false;
+};
@@ -0,0 +1,109 @@
+#include "PitchShifter.h"
+
+void PitchShifter::prepare(double sampleRate, int newNumChannels, float* const* tapScratch)
+{
+    taps = tapScratch;
+    numChannels = newNumChannels;
+
+    for (int i = 0; i <= windowTableSize; ++i)
+    {
+        const float s = std::sin(juce::MathConstants<float>::pi * static_cast<float>(i) / windowTableSize);
+        windowTable[(size_t) i] = s * s;
+    }
+
+    windowLength = static_cast<float>(juce::roundToInt(sampleRate * windowSeconds));
+
+    // Room for the whole sweep plus the interpolation neighbour
+    const int ringSize = juce::nextPowerOfTwo(static_cast<int>(windowLength) + 4);
+    ringMask = ringSize - 1;
+    rings.assign(static_cast<size_t>(numChannels * ringSize), 0.0f);
+    writeIndex.assign(static_cast<size_t>(numChannels), 0);
+
+    ratioSmoother.reset(sampleRate, 0.05); // 50ms smoothing
+    reset();
+}
+
+void PitchShifter::reset()
+{
+    std::fill(rings.begin(), rings.end(), 0.0f);
+    std::fill(writeIndex.begin(), writeIndex.end(), 0);
+    phase = 0.0f;
+    snapRatio = true; // resume at the current pitch instead of gliding from a stale one
+}
+
+void PitchShifter::process(float* const* channels, int channelsToProcess, int numSamples, float ratio, float mix)
+{
+    if (snapRatio)
+    {
+        ratioSmoother.setCurrentAndTargetValue(ratio);
+        snapRatio = false;
+    }
+    else
+    {
+        ratioSmoother.setTargetValue(ratio);
+    }
+
+    // === TAPS ===
+    // Each tap's delay grows by (1 - ratio) per sample and wraps after one
+    // window; tap B trails tap A by half a window. Each input sample is written
+    // to the ring before the taps read, and delays start at one sample so the
+    // interpolation's second tap reaches at most that newest sample, never the
+    // slot beyond it that still holds a sample from a full ring ago.
+    auto* tapDelayA = taps[delayA];
+    auto* tapGainA = taps[gainA];
+    auto* tapDelayB = taps[delayB];
+    auto* tapGainB = taps[gainB];
+    const float inverseWindow = 1.0f / windowLength;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        phase += (1.0f - ratioSmoother.getNextValue()) * inverseWindow;
+        phase -= std::floor(phase);
+        if (phase >= 1.0f)
+            phase = 0.0f;
+
+        float phaseB = phase + 0.5f;
+        if (phaseB >= 1.0f)
+            phaseB -= 1.0f;
+
+        tapDelayA[i] = 1.0f + phase * windowLength;
+        tapGainA[i] = windowGain(phase);
+        tapDelayB[i] = 1.0f + phaseB * windowLength;
+        tapGainB[i] = windowGain(phaseB);
+    }
+
+    // === READS ===
+    channelsToProcess = juce::jmin(channelsToProcess, numChannels);
+
+    for (int channel = 0; channel < channelsToProcess; ++channel)
+    {
+        auto* data = channels[channel];
+        auto* ring = rings.data() + channel * (ringMask + 1);
+        int w = writeIndex[(size_t) channel];
+
+        auto readTap = [ring, this](int head, float delay)
+        {
+            const float position = static_cast<float>(head) - delay;
+            const float floorPosition = std::floor(position);
+            const int index = static_cast<int>(floorPosition);
+            const float fraction = position - floorPosition;
+            const float a = ring[index & ringMask];
+            const float b = ring[(index + 1) & ringMask];
+            return a + fraction * (b - a);
+        };
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float input = data[i];
+            ring[w] = input;
+
+            const float shifted = readTap(w, tapDelayA[i]) * tapGainA[i]
+                                + readTap(w, tapDelayB[i]) * tapGainB[i];
+
+            data[i] = input + (shifted - input) * mix;
+            w = (w + 1) & ringMask;
+        }
+
+        writeIndex[(size_t) channel] = w;
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+// Time-domain pitch shifter: two read taps sweep through a short delay line
+// at the pitch ratio, half a window apart, and each is faded by a raised-sine
+// window that is zero where its tap jumps back. The two gains always sum to
+// one, so the output level stays flat.
+//
+// The smoothed ratio is applied per sample. Tap delays and gains are the same
+// for every channel, so they are worked out once per block into scratch and
+// the per-channel loop only does the two interpolated reads.
+//==============================================================================
+class PitchShifter
+{
+public:
+    // tapScratch must have numTapScratchChannels channels of maxBlockSize floats
+    enum TapScratch { delayA = 0, gainA, delayB, gainB, numTapScratchChannels };
+
+    void prepare (double sampleRate, int numChannels, float* const* tapScratch);
+    void reset();
+
+    // ratio = output/input frequency, mix = 0..1 shifted signal against the input.
+    // Channels beyond the prepared count pass through.
+    void process (float* const* channels, int channelsToProcess, int numSamples, float ratio, float mix);
+
+    // Length of the tap sweep, so also the longest the shifter holds a sample
+    static constexpr double windowSeconds = 0.05;
+
+private:
+    static constexpr int windowTableSize = 1024;
+
+    float windowGain (float phase) const noexcept
+    {
+        const float index = phase * windowTableSize;
+        const int i = static_cast<int> (index);
+        return windowTable[(size_t) i] + (index - i) * (windowTable[(size_t) i + 1] - windowTable[(size_t) i]);
+    }
+
+    std::array<float, windowTableSize + 1> windowTable {};
+
+    // One ring per channel, back to back in a single allocation
+    std::vector<float> rings;
+    std::vector<int> writeIndex;
+    int numChannels = 0;
+    int ringMask = 0;
+
+    float windowLength = 1.0f; // tap sweep range in samples
+    float phase = 0.0f;        // 0..1, position of tap A in the window
+    juce::SmoothedValue<float> ratioSmoother;
+    bool snapRatio = true;
+
+    float* const* taps = nullptr;
+};
@@ -100,6 +100,80 @@ void WaterfallLookAndFeel::drawButtonBackground(juce::Graphics& g, juce::Button&
     g.drawRoundedRectangle(bounds, bounds.getHeight() * 0.5f, 2.0f);
 }
 
+// ================================================================================
+// CachedBackground Implementation
+// ================================================================================
+
+void CachedBackground::draw(juce::Graphics& g, juce::Rectangle<int> bounds)
+{
+    // Render at the physical pixel density so the blit stays sharp on HiDPI
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    
+    if (image.isNull() || bounds != imageBounds || scale != imageScale)
+    {
+        imageBounds = bounds;
+        imageScale = scale;
+        image = juce::Image(juce::Image::RGB,
+                            juce::jmax(1, juce::roundToInt(bounds.getWidth() * scale)),
+                            juce::jmax(1, juce::roundToInt(bounds.getHeight() * scale)), true);
+        
+        juce::Graphics imageGraphics(image);
+        imageGraphics.addTransform(juce::AffineTransform::scale(scale).translated(-bounds.getX() * scale, -bounds.getY() * scale));
+        painter(imageGraphics);
+    }
+    
+    g.drawImageTransformed(image, juce::AffineTransform::scale(1.0f / scale).translated(static_cast<float>(bounds.getX()), static_cast<float>(bounds.getY())));
+}
+
+// ================================================================================
+// FrameScheduler Implementation
+// ================================================================================
+
+FrameScheduler::FrameScheduler(juce::Component& host)
+    : vblank(&host, [this]() { onVBlank(); })
+{
+}
+
+void FrameScheduler::add(Client& client, juce::Component& component, double framesPerSecond)
+{
+    const bool isShowing = component.isShowing();
+    entries.push_back({ &client, &component, 1.0 / framesPerSecond, 0.0, isShowing });
+    client.showingChanged(isShowing);
+}
+
+void FrameScheduler::remove(Client& client)
+{
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&](const Entry& entry) { return entry.client == &client; }),
+                  entries.end());
+}
+
+void FrameScheduler::onVBlank()
+{
+    const double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    
+    for (auto& entry : entries)
+    {
+        const bool isShowing = entry.component->isShowing();
+        if (isShowing != entry.wasShowing)
+        {
+            entry.wasShowing = isShowing;
+            entry.client->showingChanged(isShowing);
+        }
+        
+        // A quarter-interval of slack keeps a client running at the display
+        // rate from skipping frames on vblank jitter
+        if (!isShowing || now < entry.nextFrameTime - 0.25 * entry.interval)
+            continue;
+        
+        // Catch up after a pause instead of firing a burst of frames
+        entry.nextFrameTime = juce::jmax(entry.nextFrameTime, now - entry.interval) + entry.interval;
+        
+        if (entry.client->advanceFrame())
+            entry.component->repaint();
+    }
+}
+
 // ================================================================================
 // CustomKnob Implementation (unchanged)
 // ================================================================================
@@ -156,15 +230,15 @@ void CustomKnob::mouseExit(const juce::MouseEvent& event)
 // WaveformDisplay Implementation
 // ================================================================================
 
-WaveformDisplay::WaveformDisplay(MyPluginAudioProcessor& processor)
-    : audioProcessor(processor)
+WaveformDisplay::WaveformDisplay(MyPluginAudioProcessor& processor, FrameScheduler& scheduler)
+    : audioProcessor(processor), frameScheduler(scheduler)
 {
-    startTimerHz(60); // 60 FPS for smooth animation
+    frameScheduler.add(*this, *this, 60.0); // 60 FPS for smooth animation
 }
 
 WaveformDisplay::~WaveformDisplay()
 {
-    stopTimer();
+    frameScheduler.remove(*this);
 }
 
 void WaveformDisplay::paint(juce::Graphics& g)
@@ -183,23 +257,27 @@ void WaveformDisplay::paint(juce::Graphics& g)
     g.setColour(juce::Colour(0xffa0c0a0));
     g.setFont(14.0f);
     auto titleArea = bounds.removeFromTop(25);
-    g.drawText("Real-time Waveform", titleArea, juce::Justification::centred);
+    g.drawText("Input / Output Scope", titleArea, juce::Justification::centred);
     
     // Waveform
     bounds.reduce(10, 5);
     
-    if (!waveformPath.isEmpty())
+    if (!outputPath.isEmpty() || !inputPath.isEmpty())
     {
-        // Gradient fill
+        // Input envelope behind the output
+        g.setColour(juce::Colour(0x30a0c0a0));
+        g.fillPath(inputPath);
+        
+        // Output min/max envelope, gradient fill
         juce::ColourGradient waveGradient(
-            juce::Colour(0xff64c896), bounds.getX(), bounds.getCentreY(),
-            juce::Colour(0xff4a90e2), bounds.getRight(), bounds.getCentreY(), false);
+            juce::Colour(0xa064c896), bounds.getX(), bounds.getCentreY(),
+            juce::Colour(0xa04a90e2), bounds.getRight(), bounds.getCentreY(), false);
         g.setGradientFill(waveGradient);
-        g.strokePath(waveformPath, juce::PathStrokeType(2.0f));
+        g.fillPath(outputPath);
         
-        // Glow effect
-        g.setColour(juce::Colour(0x4064c896));
-        g.strokePath(waveformPath, juce::PathStrokeType(4.0f));
+        // Output RMS
+        g.setColour(juce::Colour(0xffe0f0e0));
+        g.strokePath(rmsPath, juce::PathStrokeType(1.5f));
     }
     else
     {
@@ -210,50 +288,439 @@ void WaveformDisplay::paint(juce::Graphics& g)
     }
 }
 
-void WaveformDisplay::timerCallback()
+bool WaveformDisplay::advanceFrame()
 {
-    if (audioProcessor.waveformData.hasNewData.load())
+    // Drain everything the audio thread has queued since the last frame
+    const int numFrames = audioProcessor.scopeFifo.pop(incoming.data(), static_cast<int>(incoming.size()));
+    if (numFrames == 0)
+        return false;
+    
+    for (int i = 0; i < numFrames; ++i)
     {
-        // Copy waveform data
-        int readIndex = audioProcessor.waveformData.writeIndex.load();
-        for (int i = 0; i < displayBuffer.size(); ++i)
-        {
-            int sourceIndex = (readIndex - displayBuffer.size() + i + audioProcessor.waveformData.buffer.size()) 
-                             % audioProcessor.waveformData.buffer.size();
-            displayBuffer[i] = audioProcessor.waveformData.buffer[sourceIndex];
-        }
+        history[(size_t) historyWrite] = incoming[(size_t) i];
+        historyWrite = (historyWrite + 1) % historySize;
+    }
+    
+    // Once the history is all silence, the "No signal" frame is already up
+    const bool hadSignal = !outputPath.isEmpty() || !inputPath.isEmpty();
+    rebuildPaths();
+    return hadSignal || !outputPath.isEmpty() || !inputPath.isEmpty();
+}
+
+void WaveformDisplay::rebuildPaths()
+{
+    inputPath.clear();
+    outputPath.clear();
+    rmsPath.clear();
+    
+    auto bounds = getLocalBounds().withTrimmedTop(25).reduced(10, 5).toFloat();
+    if (bounds.isEmpty())
+        return;
+    
+    // Oldest frame on the left, newest on the right, fixed +-1 scale
+    const float halfHeight = bounds.getHeight() * 0.5f;
+    auto xAt = [&](int i) { return juce::jmap(float(i), 0.0f, float(historySize - 1), bounds.getX(), bounds.getRight()); };
+    auto yAt = [&](float value) { return bounds.getCentreY() - juce::jlimit(-1.0f, 1.0f, value) * halfHeight; };
+    auto frameAt = [this](int i) -> const ScopeFrame& { return history[(size_t) ((historyWrite + i) % historySize)]; };
+    
+    bool hasSignal = false;
+    for (const auto& frame : history)
+        hasSignal = hasSignal || frame.input.max - frame.input.min > 1.0e-5f || frame.output.max - frame.output.min > 1.0e-5f;
+    
+    if (!hasSignal)
+        return;
+    
+    // Envelopes: along the maxima left to right, back along the minima
+    auto buildEnvelope = [&](juce::Path& path, auto level)
+    {
+        path.startNewSubPath(xAt(0), yAt(level(frameAt(0)).max));
+        for (int i = 1; i < historySize; ++i)
+            path.lineTo(xAt(i), yAt(level(frameAt(i)).max));
+        for (int i = historySize - 1; i >= 0; --i)
+            path.lineTo(xAt(i), yAt(level(frameAt(i)).min));
+        path.closeSubPath();
+    };
+    
+    buildEnvelope(inputPath, [](const ScopeFrame& frame) { return frame.input; });
+    buildEnvelope(outputPath, [](const ScopeFrame& frame) { return frame.output; });
+    
+    // RMS mirrored about the centre line
+    for (const float sign : { 1.0f, -1.0f })
+    {
+        rmsPath.startNewSubPath(xAt(0), yAt(sign * frameAt(0).output.rms));
+        for (int i = 1; i < historySize; ++i)
+            rmsPath.lineTo(xAt(i), yAt(sign * frameAt(i).output.rms));
+    }
+}
+
+// ================================================================================
+// DelayMemoryDisplay Implementation
+// ================================================================================
+
+DelayMemoryDisplay::DelayMemoryDisplay(MyPluginAudioProcessor& processor, FrameScheduler& scheduler)
+    : audioProcessor(processor), frameScheduler(scheduler)
+{
+    frameScheduler.add(*this, *this, 30.0);
+}
+
+DelayMemoryDisplay::~DelayMemoryDisplay()
+{
+    frameScheduler.remove(*this);
+}
+
+void DelayMemoryDisplay::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds();
+    
+    // Background
+    g.setColour(juce::Colour(0x80000000));
+    g.fillRoundedRectangle(bounds.toFloat(), 10.0f);
+    
+    // Border
+    g.setColour(juce::Colour(0x4064c896));
+    g.drawRoundedRectangle(bounds.toFloat(), 10.0f, 2.0f);
+    
+    // Title, with how much history is on screen
+    g.setColour(juce::Colour(0xffa0c0a0));
+    g.setFont(14.0f);
+    auto titleArea = bounds.removeFromTop(25);
+    g.drawText("Delay Memory", titleArea, juce::Justification::centred);
+    
+    const double sampleRate = audioProcessor.getSampleRate();
+    if (sampleRate > 0.0)
+    {
+        const double seconds = audioProcessor.delayPeaks.getRingSize() * zoom / sampleRate;
+        g.setFont(11.0f);
+        g.drawText(juce::String(seconds, seconds < 0.1 ? 3 : 2) + " s", titleArea.reduced(12, 0), juce::Justification::centredRight);
+    }
+    
+    bounds.reduce(10, 5);
+    
+    // Ring contents, newest at the right edge where the write head is
+    juce::ColourGradient peakGradient(
+        juce::Colour(0x604a90e2), bounds.getX(), bounds.getCentreY(),
+        juce::Colour(0xa064c896), bounds.getRight(), bounds.getCentreY(), false);
+    g.setGradientFill(peakGradient);
+    g.fillPath(peakPath);
+    
+    // Where the playing grains are reading
+    g.setColour(juce::Colour(0xc0f72585));
+    g.strokePath(grainPath, juce::PathStrokeType(1.0f));
+    
+    g.setColour(juce::Colour(0xffe0f0e0));
+    g.fillRect(juce::Rectangle<int>(bounds.getRight() - 1, bounds.getY(), 2, bounds.getHeight()));
+}
+
+void DelayMemoryDisplay::resized()
+{
+    columns.resize(static_cast<size_t>(getLocalBounds().reduced(10, 5).getWidth()));
+    rebuildPaths();
+}
+
+bool DelayMemoryDisplay::advanceFrame()
+{
+    // The ring only changes while the write head moves
+    const int writeHead = audioProcessor.delayPeaks.getWriteHead();
+    if (writeHead == lastWriteHead)
+        return false;
+    
+    lastWriteHead = writeHead;
+    rebuildPaths();
+    return true;
+}
+
+void DelayMemoryDisplay::mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel)
+{
+    zoom = juce::jlimit(minZoom, 1.0f, zoom * std::pow(2.0f, -wheel.deltaY * 2.0f));
+    rebuildPaths();
+    repaint();
+}
+
+void DelayMemoryDisplay::mouseDoubleClick(const juce::MouseEvent&)
+{
+    zoom = 1.0f;
+    rebuildPaths();
+    repaint();
+}
+
+void DelayMemoryDisplay::rebuildPaths()
+{
+    peakPath.clear();
+    grainPath.clear();
+    
+    const auto& peaks = audioProcessor.delayPeaks;
+    const int ringSize = peaks.getRingSize();
+    auto bounds = getLocalBounds().withTrimmedTop(25).reduced(10, 5).toFloat();
+    const int numColumns = static_cast<int>(columns.size());
+    if (ringSize == 0 || numColumns < 2)
+        return;
+    
+    // Each pixel column asks the pyramid for its span; the pyramid picks the
+    // level, so the cost is per column at every zoom
+    const int span = juce::jmax(numColumns, static_cast<int>(ringSize * zoom));
+    const int writeHead = peaks.getWriteHead();
+    const int viewStart = (writeHead - span) & (ringSize - 1);
+    const double samplesPerColumn = static_cast<double>(span) / numColumns;
+    
+    const float halfHeight = bounds.getHeight() * 0.5f;
+    auto yAt = [&](float value) { return bounds.getCentreY() - juce::jlimit(-1.0f, 1.0f, value) * halfHeight; };
+    
+    for (int x = 0; x < numColumns; ++x)
+    {
+        const int first = static_cast<int>(x * samplesPerColumn);
+        const int last = static_cast<int>((x + 1) * samplesPerColumn);
+        columns[(size_t) x] = peaks.getRange(viewStart + first, juce::jmax(1, last - first));
+    }
+    
+    // Along the maxima left to right, back along the minima
+    peakPath.startNewSubPath(bounds.getX(), yAt(columns[0].getEnd()));
+    for (int x = 1; x < numColumns; ++x)
+        peakPath.lineTo(bounds.getX() + x, yAt(columns[(size_t) x].getEnd()));
+    for (int x = numColumns - 1; x >= 0; --x)
+        peakPath.lineTo(bounds.getX() + x, yAt(columns[(size_t) x].getStart()));
+    peakPath.closeSubPath();
+    
+    const int numGrains = peaks.getGrainPositions(grainPositions.data(), static_cast<int>(grainPositions.size()));
+    for (int i = 0; i < numGrains; ++i)
+    {
+        const int offset = (grainPositions[(size_t) i] - viewStart) & (ringSize - 1);
+        if (offset >= span)
+            continue; // further back than the current zoom shows
         
-        // Create waveform path
-        waveformPath.clear();
-        auto bounds = getLocalBounds().reduced(10, 30).reduced(10, 5);
+        const float x = bounds.getX() + static_cast<float>(offset / samplesPerColumn);
+        grainPath.startNewSubPath(x, bounds.getY());
+        grainPath.lineTo(x, bounds.getBottom());
+    }
+}
+
+// ================================================================================
+// SpectrumDisplay Implementation
+// ================================================================================
+
+SpectrumDisplay::SpectrumDisplay(MyPluginAudioProcessor& processor, FrameScheduler& scheduler)
+    : audioProcessor(processor),
+      frameScheduler(scheduler),
+      analyser(processor.inputSpectrum, processor.outputSpectrum)
+{
+    for (size_t i = 0; i < filterParamIds.size(); ++i)
+        filterParams[i] = processor.valueTreeState.getRawParameterValue(Params::table[filterParamIds[i]].id);
+    
+    fftSizeBox.addItemList(SpectrumAnalyser::getFftSizeNames(), 1);
+    fftSizeBox.setSelectedId(SpectrumAnalyser::fft2048 + 1, juce::dontSendNotification);
+    fftSizeBox.onChange = [this]() {
+        analyser.setFftSize(static_cast<SpectrumAnalyser::FftSize>(fftSizeBox.getSelectedId() - 1));
+    };
+    addAndMakeVisible(fftSizeBox);
+    
+    // Smoothing per FFT frame for each averaging choice
+    static constexpr float averagingAmounts[] = { 0.0f, 0.5f, 0.8f, 0.93f };
+    averagingBox.addItemList({ "No Avg", "Light Avg", "Medium Avg", "Heavy Avg" }, 1);
+    averagingBox.setSelectedId(3, juce::dontSendNotification);
+    averagingBox.onChange = [this]() {
+        analyser.setAveraging(averagingAmounts[juce::jlimit(0, 3, averagingBox.getSelectedId() - 1)]);
+    };
+    analyser.setAveraging(averagingAmounts[2]);
+    addAndMakeVisible(averagingBox);
+    
+    peakHoldButton.setButtonText("Peak Hold");
+    peakHoldButton.onClick = [this]() { analyser.setPeakHold(peakHoldButton.getToggleState()); };
+    addAndMakeVisible(peakHoldButton);
+    
+    frameScheduler.add(*this, *this, 30.0);
+}
+
+SpectrumDisplay::~SpectrumDisplay()
+{
+    frameScheduler.remove(*this);
+}
+
+void SpectrumDisplay::resized()
+{
+    auto titleArea = getLocalBounds().removeFromTop(25).reduced(10, 2);
+    peakHoldButton.setBounds(titleArea.removeFromRight(90));
+    averagingBox.setBounds(titleArea.removeFromRight(100).reduced(3, 0));
+    fftSizeBox.setBounds(titleArea.removeFromRight(75).reduced(3, 0));
+}
+
+juce::Rectangle<float> SpectrumDisplay::getPlotArea() const
+{
+    return getLocalBounds().withTrimmedTop(25).reduced(10, 5).toFloat();
+}
+
+float SpectrumDisplay::xForFrequency(float hz) const
+{
+    const auto plot = getPlotArea();
+    const float proportion = std::log(hz / minFrequency) / std::log(maxFrequency / minFrequency);
+    return plot.getX() + proportion * plot.getWidth();
+}
+
+float SpectrumDisplay::yForDecibels(float decibels) const
+{
+    const auto plot = getPlotArea();
+    return juce::jmap(juce::jlimit(SpectrumAnalyser::minDecibels, maxDecibels, decibels),
+                      SpectrumAnalyser::minDecibels, maxDecibels, plot.getBottom(), plot.getY());
+}
+
+void SpectrumDisplay::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds();
+    
+    // Background
+    g.setColour(juce::Colour(0x80000000));
+    g.fillRoundedRectangle(bounds.toFloat(), 10.0f);
+    
+    // Border
+    g.setColour(juce::Colour(0x4064c896));
+    g.drawRoundedRectangle(bounds.toFloat(), 10.0f, 2.0f);
+    
+    // Title
+    g.setColour(juce::Colour(0xffa0c0a0));
+    g.setFont(14.0f);
+    g.drawText("Spectrum", bounds.removeFromTop(25).reduced(12, 0), juce::Justification::centredLeft);
+    
+    // Decade and 24 dB grid
+    const auto plot = getPlotArea();
+    g.setFont(10.0f);
+    for (const float hz : { 100.0f, 1000.0f, 10000.0f })
+    {
+        const float x = xForFrequency(hz);
+        g.setColour(juce::Colour(0x2064c896));
+        g.drawVerticalLine(juce::roundToInt(x), plot.getY(), plot.getBottom());
+        g.setColour(juce::Colour(0x80a0c0a0));
+        g.drawText(hz >= 1000.0f ? juce::String(juce::roundToInt(hz / 1000.0f)) + "k" : juce::String(juce::roundToInt(hz)),
+                   juce::Rectangle<float>(x + 2.0f, plot.getBottom() - 12.0f, 30.0f, 12.0f), juce::Justification::centredLeft);
+    }
+    for (const float decibels : { 0.0f, -24.0f, -48.0f, -72.0f })
+    {
+        const float y = yForDecibels(decibels);
+        g.setColour(juce::Colour(0x2064c896));
+        g.drawHorizontalLine(juce::roundToInt(y), plot.getX(), plot.getRight());
+        g.setColour(juce::Colour(0x80a0c0a0));
+        g.drawText(juce::String(juce::roundToInt(decibels)), juce::Rectangle<float>(plot.getX() + 2.0f, y, 30.0f, 12.0f), juce::Justification::centredLeft);
+    }
+    
+    // Input behind, output in front
+    g.setColour(juce::Colour(0x60a0c0a0));
+    g.strokePath(inputPath, juce::PathStrokeType(1.0f));
+    
+    juce::ColourGradient outputGradient(
+        juce::Colour(0xa064c896), plot.getX(), plot.getCentreY(),
+        juce::Colour(0xa04a90e2), plot.getRight(), plot.getCentreY(), false);
+    g.setGradientFill(outputGradient);
+    g.strokePath(outputPath, juce::PathStrokeType(1.5f));
+    
+    if (peakHoldButton.getToggleState())
+    {
+        g.setColour(juce::Colour(0x90f72585));
+        g.strokePath(peakPath, juce::PathStrokeType(1.0f));
+    }
+    
+    // What the filter stage is set to
+    g.setColour(juce::Colour(0xff00d9ff));
+    g.strokePath(filterPath, juce::PathStrokeType(2.0f));
+}
+
+bool SpectrumDisplay::advanceFrame()
+{
+    std::array<float, 4> currentFilterSettings;
+    for (size_t i = 0; i < filterParams.size(); ++i)
+        currentFilterSettings[i] = filterParams[i]->load();
+    
+    const bool hasNewSpectrum = analyser.getLatest(spectrum);
+    if (!hasNewSpectrum && currentFilterSettings == filterSettings)
+        return false;
+    
+    filterSettings = currentFilterSettings;
+    rebuildPaths();
+    return true;
+}
+
+void SpectrumDisplay::showingChanged(bool isShowing)
+{
+    analyser.setActive(isShowing);
+}
+
+void SpectrumDisplay::rebuildPaths()
+{
+    inputPath.clear();
+    outputPath.clear();
+    peakPath.clear();
+    filterPath.clear();
+    
+    const auto plot = getPlotArea();
+    const int numColumns = static_cast<int>(plot.getWidth());
+    const auto sampleRate = static_cast<float>(audioProcessor.getSampleRate());
+    if (numColumns < 2 || sampleRate <= 0.0f)
+        return;
+    
+    const float nyquist = sampleRate * 0.5f;
+    auto frequencyAt = [&](int column)
+    {
+        return minFrequency * std::pow(maxFrequency / minFrequency, static_cast<float>(column) / numColumns);
+    };
+    
+    // One point per pixel column: the loudest bin under it, so narrow peaks
+    // survive at the top of the range where many bins share a column
+    if (spectrum.fftSize > 0)
+    {
+        const float binsPerHz = static_cast<float>(spectrum.fftSize) / sampleRate;
+        const int lastBin = static_cast<int>(spectrum.output.size()) - 1;
         
-        if (bounds.getWidth() > 0 && bounds.getHeight() > 0)
+        auto buildTrace = [&](juce::Path& path, const std::vector<float>& levels)
         {
-            float maxValue = 0.001f; // Avoid division by zero
-            for (float value : displayBuffer)
-                maxValue = juce::jmax(maxValue, std::abs(value));
-            
-            bool hasStarted = false;
-            for (int i = 0; i < displayBuffer.size(); ++i)
+            for (int column = 0; column < numColumns; ++column)
             {
-                float x = juce::jmap(float(i), 0.0f, float(displayBuffer.size() - 1), 
-                                   float(bounds.getX()), float(bounds.getRight()));
-                float y = bounds.getCentreY() - (displayBuffer[i] / maxValue) * bounds.getHeight() * 0.4f;
+                const float low = frequencyAt(column), high = frequencyAt(column + 1);
+                if (low >= nyquist)
+                    break;
+                
+                const int firstBin = juce::jlimit(0, lastBin, juce::roundToInt(low * binsPerHz));
+                const int endBin = juce::jlimit(firstBin + 1, lastBin + 1, juce::roundToInt(high * binsPerHz));
+                const float level = *std::max_element(levels.begin() + firstBin, levels.begin() + endBin);
                 
-                if (!hasStarted)
-                {
-                    waveformPath.startNewSubPath(x, y);
-                    hasStarted = true;
-                }
+                const float x = plot.getX() + column, y = yForDecibels(level);
+                if (column == 0)
+                    path.startNewSubPath(x, y);
                 else
-                {
-                    waveformPath.lineTo(x, y);
-                }
+                    path.lineTo(x, y);
             }
-        }
+        };
+        
+        buildTrace(inputPath, spectrum.input);
+        buildTrace(outputPath, spectrum.output);
+        buildTrace(peakPath, spectrum.outputPeak);
+    }
+    
+    // Filter response of the TPT state-variable filter. With its prewarped
+    // bilinear transform the digital response is the analogue prototype at
+    // w = tan(pi f / fs) / tan(pi fc / fs).
+    // filterSettings is in filterParamIds order: enabled, cutoff, resonance, type.
+    if (filterSettings[0] < 0.5f)
+        return;
+    
+    const float cutoff = juce::jmin(ParamSnapshot::filterCutoffToHz(filterSettings[1]), nyquist * 0.999f);
+    const float q = ParamSnapshot::filterResonanceToQ(filterSettings[2]);
+    const auto mode = ParamSnapshot::filterTypeToMode(filterSettings[3]);
+    const float pi = juce::MathConstants<float>::pi;
+    const float prewarp = std::tan(pi * cutoff / sampleRate);
+    
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const float hz = frequencyAt(column);
+        if (hz >= nyquist)
+            break;
         
-        audioProcessor.waveformData.hasNewData = false;
-        repaint();
+        const float w = std::tan(pi * hz / sampleRate) / prewarp;
+        const float denominator = std::sqrt((1.0f - w * w) * (1.0f - w * w) + (w / q) * (w / q));
+        const float numerator = mode == ParamSnapshot::lowpass  ? 1.0f
+                              : mode == ParamSnapshot::bandpass ? w
+                                                                : w * w;
+        const float y = yForDecibels(juce::Decibels::gainToDecibels(numerator / denominator, SpectrumAnalyser::minDecibels));
+        
+        if (column == 0)
+            filterPath.startNewSubPath(plot.getX() + column, y);
+        else
+            filterPath.lineTo(plot.getX() + column, y);
     }
 }
 
@@ -278,6 +745,11 @@ FilterSection::FilterSection(juce::AudioProcessorValueTreeState& vts)
     filterTypeBox.setSelectedId(1);
     addAndMakeVisible(filterTypeBox);
     
+    filterEnabledButton.setButtonText("On");
+    addAndMakeVisible(filterEnabledButton);
+    filterEnabledAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        vts, "filterEnabled", filterEnabledButton);
+    
     filterTypeLabel.setText("Type", juce::dontSendNotification);
     filterTypeLabel.setJustificationType(juce::Justification::centred);
     filterTypeLabel.setColour(juce::Label::textColourId, juce::Colour(0xffa0c0a0));
@@ -330,6 +802,7 @@ void FilterSection::resized()
     resonanceKnob->setBounds(knobArea.reduced(5));
     
     bounds.removeFromTop(5);
+    filterEnabledButton.setBounds(bounds.removeFromLeft(50).reduced(2));
     filterTypeLabel.setBounds(bounds.removeFromTop(15));
     filterTypeBox.setBounds(bounds.reduced(5));
 }
@@ -347,6 +820,26 @@ PitchSection::PitchSection(juce::AudioProcessorValueTreeState& vts)
     octavesKnob = std::make_unique<CustomKnob>(vts, "pitchOctaves", "Octaves", 
         "Pitch Octaves → Coarse pitch adjustment (-2 to +2 octaves)");
     addAndMakeVisible(*octavesKnob);
+    
+    mixKnob = std::make_unique<CustomKnob>(vts, "pitchMix", "Mix", 
+        "Pitch Mix → Blend of shifted and unshifted signal");
+    addAndMakeVisible(*mixKnob);
+    
+    // Engine and phase vocoder quality
+    modeBox.addItemList(PhaseVocoder::getPitchModeNames(), 1);
+    addAndMakeVisible(modeBox);
+    modeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        vts, "pitchMode", modeBox);
+    
+    fftSizeBox.addItemList(PhaseVocoder::getFftSizeNames(), 1);
+    addAndMakeVisible(fftSizeBox);
+    fftSizeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        vts, "pitchFftSize", fftSizeBox);
+    
+    overlapBox.addItemList(PhaseVocoder::getOverlapNames(), 1);
+    addAndMakeVisible(overlapBox);
+    overlapAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        vts, "pitchOverlap", overlapBox);
 }
 
 PitchSection::~PitchSection() = default;
@@ -372,8 +865,15 @@ void PitchSection::resized()
     bounds.removeFromTop(30);
     bounds.reduce(10, 5);
     
-    semitonesKnob->setBounds(bounds.removeFromTop(bounds.getHeight() / 2).reduced(5));
-    octavesKnob->setBounds(bounds.reduced(5));
+    auto comboRow = bounds.removeFromBottom(22);
+    modeBox.setBounds(comboRow.removeFromLeft(comboRow.getWidth() / 2).reduced(2));
+    fftSizeBox.setBounds(comboRow.removeFromLeft(comboRow.getWidth() / 2).reduced(2));
+    overlapBox.setBounds(comboRow.reduced(2));
+    
+    auto topRow = bounds.removeFromTop(bounds.getHeight() / 2);
+    semitonesKnob->setBounds(topRow.removeFromLeft(topRow.getWidth() / 2).reduced(5));
+    octavesKnob->setBounds(topRow.reduced(5));
+    mixKnob->setBounds(bounds.reduced(5));
 }
 
 // ================================================================================
@@ -431,6 +931,12 @@ LfoPanSection::LfoPanSection(juce::AudioProcessorValueTreeState& vts)
     panKnob = std::make_unique<CustomKnob>(vts, "panPosition", "Pan", 
         "Pan Position → Controls stereo positioning (-100% Left to +100% Right)");
     addAndMakeVisible(*panKnob);
+    
+    // Pan mode
+    panModeBox.addItemList(PanStage::getModeNames(), 1);
+    addAndMakeVisible(panModeBox);
+    panModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        vts, "panMode", panModeBox);
 }
 
 LfoPanSection::~LfoPanSection() = default;
@@ -464,10 +970,11 @@ void LfoPanSection::resized()
     
     bounds.removeFromTop(5);
     
-    // Target and waveform row
+    // Target, waveform and pan mode row
     auto comboRow = bounds.removeFromTop(25);
-    lfoTargetBox.setBounds(comboRow.removeFromLeft(comboRow.getWidth() / 2).reduced(2));
-    lfoWaveformBox.setBounds(comboRow.reduced(2));
+    lfoTargetBox.setBounds(comboRow.removeFromLeft(comboRow.getWidth() / 3).reduced(2));
+    lfoWaveformBox.setBounds(comboRow.removeFromLeft(comboRow.getWidth() / 2).reduced(2));
+    panModeBox.setBounds(comboRow.reduced(2));
     
     bounds.removeFromTop(5);
     
@@ -595,18 +1102,17 @@ void FlangerSection::resized()
 // Main Tab Component Implementation
 // ================================================================================
 
-MainTabComponent::MainTabComponent(MyPluginAudioProcessor& processor)
-    : audioProcessor(processor)
+MainTabComponent::MainTabComponent(MyPluginAudioProcessor& processor, FrameScheduler& scheduler)
+    : audioProcessor(processor), frameScheduler(scheduler)
 {
+    // The cached background covers every pixel, so nothing behind needs repainting
+    setOpaque(true);
+    
     setupControls();
     setupSections();
-    startTimerHz(30);
 }
 
-MainTabComponent::~MainTabComponent()
-{
-    stopTimer();
-}
+MainTabComponent::~MainTabComponent() = default;
 
 void MainTabComponent::setupControls()
 {
@@ -631,8 +1137,49 @@ void MainTabComponent::setupControls()
     mixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.valueTreeState, "mix", mixSlider);
     
+    // Grain window shape
+    grainWindowBox.addItemList(GrainWindowTable::getShapeNames(), 1);
+    addAndMakeVisible(grainWindowBox);
+    grainWindowAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.valueTreeState, "grainWindow", grainWindowBox);
+    
+    grainWindowLabel.setText("Grain Window", juce::dontSendNotification);
+    grainWindowLabel.setJustificationType(juce::Justification::centred);
+    grainWindowLabel.setColour(juce::Label::textColourId, juce::Colour(0xffb19cd9));
+    addAndMakeVisible(grainWindowLabel);
+    
+    // Feedback EQ slope
+    eqSlopeBox.addItemList(FeedbackEqBase::getSlopeNames(), 1);
+    addAndMakeVisible(eqSlopeBox);
+    eqSlopeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.valueTreeState, "eqSlope", eqSlopeBox);
+    
+    // Feedback saturation character
+    saturationBox.addItemList(Saturation::getCharacterNames(), 1);
+    addAndMakeVisible(saturationBox);
+    saturationAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.valueTreeState, "saturation", saturationBox);
+    
+    // Oversampling around the feedback saturation
+    oversamplingBox.addItemList(FeedbackSaturatorBase::getFactorNames(), 1);
+    addAndMakeVisible(oversamplingBox);
+    oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.valueTreeState, "oversampling", oversamplingBox);
+    
+    // Swarm mode toggle
+    swarmButton.setButtonText("Swarm");
+    addAndMakeVisible(swarmButton);
+    swarmAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.valueTreeState, "swarmMode", swarmButton);
+    
+    // Random per-grain detune toggle
+    detuneButton.setButtonText("Detune");
+    addAndMakeVisible(detuneButton);
+    detuneAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.valueTreeState, "grainDetune", detuneButton);
+    
     // Grain visualizer
-    grainViz = std::make_unique<GrainVisualizer>();
+    grainViz = std::make_unique<GrainVisualizer>(audioProcessor, frameScheduler);
     addAndMakeVisible(*grainViz);
 }
 
@@ -660,11 +1207,12 @@ void MainTabComponent::setupSections()
     
     // Creative section
     creativeKnobs.push_back(createKnob("randomization", "Randomization", "Randomization → Adds controlled chaos to parameters"));
+    creativeKnobs.push_back(createKnob("grainPitch", "Grain Pitch", "Grain Pitch → Transposes every grain (-24 to +24 semitones)"));
 }
 
 void MainTabComponent::paint(juce::Graphics& g)
 {
-    drawWaterfallBackground(g);
+    background.draw(g, getLocalBounds());
 }
 
 void MainTabComponent::drawWaterfallBackground(juce::Graphics& g)
@@ -759,6 +1307,9 @@ void MainTabComponent::resized()
     
     // Delay section
     auto delayArea = controlArea.removeFromLeft(sectionWidth).reduced(margin);
+    auto saturationRow = delayArea.removeFromBottom(25);
+    oversamplingBox.setBounds(saturationRow.removeFromRight(saturationRow.getWidth() / 3).reduced(5, 0));
+    saturationBox.setBounds(saturationRow.reduced(5, 0));
     for (int i = 0; i < delayKnobs.size(); ++i)
     {
         auto knobArea = delayArea.removeFromTop(delayArea.getHeight() / delayKnobs.size());
@@ -767,6 +1318,7 @@ void MainTabComponent::resized()
     
     // EQ section
     auto eqArea = controlArea.removeFromLeft(sectionWidth).reduced(margin);
+    eqSlopeBox.setBounds(eqArea.removeFromBottom(25).reduced(5, 0));
     for (int i = 0; i < eqKnobs.size(); ++i)
     {
         auto knobArea = eqArea.removeFromTop(eqArea.getHeight() / eqKnobs.size());
@@ -783,6 +1335,13 @@ void MainTabComponent::resized()
     
     // Creative section
     auto creativeArea = controlArea.reduced(margin);
+    auto toggleRow = creativeArea.removeFromBottom(25);
+    detuneButton.setBounds(toggleRow.removeFromRight(toggleRow.getWidth() / 2).reduced(5, 0));
+    swarmButton.setBounds(toggleRow.reduced(5, 0));
+    auto windowArea = creativeArea.removeFromBottom(50);
+    grainWindowLabel.setBounds(windowArea.removeFromTop(20));
+    grainWindowBox.setBounds(windowArea.reduced(5, 2));
+    
     for (int i = 0; i < creativeKnobs.size(); ++i)
     {
         auto knobArea = creativeArea.removeFromTop(creativeArea.getHeight() / creativeKnobs.size());
@@ -798,29 +1357,25 @@ void MainTabComponent::resized()
     mixSlider.setBounds(footerArea);
 }
 
-void MainTabComponent::timerCallback()
-{
-    if (grainViz)
-    {
-        auto density = audioProcessor.valueTreeState.getRawParameterValue("grainDensity")->load();
-        auto size = audioProcessor.valueTreeState.getRawParameterValue("grainSize")->load();
-        auto reverse = audioProcessor.valueTreeState.getRawParameterValue("reverseGrains")->load() > 0.5f;
-        
-        grainViz->updateGrainActivity(density, size, reverse);
-    }
-}
-
 // ================================================================================
 // Advanced Tab Component Implementation
 // ================================================================================
 
-AdvancedTabComponent::AdvancedTabComponent(MyPluginAudioProcessor& processor)
+AdvancedTabComponent::AdvancedTabComponent(MyPluginAudioProcessor& processor, FrameScheduler& scheduler)
     : audioProcessor(processor)
 {
+    setOpaque(true);
+    
     // Create sections
-    waveformDisplay = std::make_unique<WaveformDisplay>(processor);
+    waveformDisplay = std::make_unique<WaveformDisplay>(processor, scheduler);
     addAndMakeVisible(*waveformDisplay);
     
+    delayMemoryDisplay = std::make_unique<DelayMemoryDisplay>(processor, scheduler);
+    addAndMakeVisible(*delayMemoryDisplay);
+    
+    spectrumDisplay = std::make_unique<SpectrumDisplay>(processor, scheduler);
+    addAndMakeVisible(*spectrumDisplay);
+    
     filterSection = std::make_unique<FilterSection>(processor.valueTreeState);
     addAndMakeVisible(*filterSection);
     
@@ -858,7 +1413,7 @@ AdvancedTabComponent::~AdvancedTabComponent() = default;
 
 void AdvancedTabComponent::paint(juce::Graphics& g)
 {
-    drawWaterfallBackground(g);
+    background.draw(g, getLocalBounds());
 }
 
 void AdvancedTabComponent::drawWaterfallBackground(juce::Graphics& g)
@@ -911,9 +1466,10 @@ void AdvancedTabComponent::resized()
 {
     auto bounds = getLocalBounds().reduced(15, 10);
     
-    // Row 1: Waveform (120px height)
+    // Row 1: Scope and delay memory side by side (120px height)
     auto waveformArea = bounds.removeFromTop(120);
-    waveformDisplay->setBounds(waveformArea);
+    waveformDisplay->setBounds(waveformArea.removeFromLeft(waveformArea.getWidth() / 2).withTrimmedRight(5));
+    delayMemoryDisplay->setBounds(waveformArea.withTrimmedLeft(5));
     
     bounds.removeFromTop(10); // Spacing
     
@@ -927,7 +1483,12 @@ void AdvancedTabComponent::resized()
     
     bounds.removeFromTop(10); // Spacing
     
-    // Row 3: Chorus, Flanger (remaining height)
+    // Row 3: Spectrum (160px height)
+    spectrumDisplay->setBounds(bounds.removeFromTop(160));
+    
+    bounds.removeFromTop(10); // Spacing
+    
+    // Row 4: Chorus, Flanger (remaining height)
     auto effectWidth = bounds.getWidth() / 2;
     chorusSection->setBounds(bounds.removeFromLeft(effectWidth).reduced(5));
     flangerSection->setBounds(bounds.reduced(5));
@@ -940,11 +1501,13 @@ void AdvancedTabComponent::resized()
 MyPluginAudioProcessorEditor::MyPluginAudioProcessorEditor(MyPluginAudioProcessor& p)
     : AudioProcessorEditor(p), audioProcessor(p)
 {
+    setOpaque(true);
+    
     setLookAndFeel(&waterfallLAF);
     
     // Create tab components
-    mainTab = std::make_unique<MainTabComponent>(audioProcessor);
-    advancedTab = std::make_unique<AdvancedTabComponent>(audioProcessor);
+    mainTab = std::make_unique<MainTabComponent>(audioProcessor, frameScheduler);
+    advancedTab = std::make_unique<AdvancedTabComponent>(audioProcessor, frameScheduler);
     
     // Set up status update callbacks
     mainTab->onStatusUpdate = [this](const juce::String& message) {
@@ -981,6 +1544,11 @@ MyPluginAudioProcessorEditor::~MyPluginAudioProcessorEditor()
 }
 
 void MyPluginAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    background.draw(g, getLocalBounds());
+}
+
+void MyPluginAudioProcessorEditor::drawBackground(juce::Graphics& g)
 {
     auto bounds = getLocalBounds();
     
@@ -1328,16 +1896,17 @@ void RandomizeButton::randomizeParameters()
     }
 }
 
-// GrainVisualizer Implementation (unchanged from original)
-GrainVisualizer::GrainVisualizer()
+// GrainVisualizer Implementation
+GrainVisualizer::GrainVisualizer(MyPluginAudioProcessor& processor, FrameScheduler& scheduler)
+    : audioProcessor(processor), frameScheduler(scheduler)
 {
-    startTimerHz(30);
-    visualGrains.resize(50);
+    visualGrains.resize(256);
+    frameScheduler.add(*this, *this, frameRate);
 }
 
 GrainVisualizer::~GrainVisualizer()
 {
-    stopTimer();
+    frameScheduler.remove(*this);
 }
 
 void GrainVisualizer::paint(juce::Graphics& g)
@@ -1389,64 +1958,75 @@ void GrainVisualizer::paint(juce::Graphics& g)
     g.drawText("Grain Cloud", bounds.removeFromTop(20), juce::Justification::centred);
 }
 
-void GrainVisualizer::timerCallback()
+bool GrainVisualizer::advanceFrame()
 {
+    const bool wasActive = hasVisibleGrains();
     updateGrains();
-    repaint();
+    
+    // Every onset the engine scheduled since the last frame
+    const double sampleRate = audioProcessor.getSampleRate();
+    const int numLanes = juce::jmax(1, audioProcessor.getTotalNumOutputChannels());
+    const int numEvents = audioProcessor.grainEvents.pop(incoming.data(), static_cast<int>(incoming.size()));
+    
+    if (sampleRate > 0.0)
+        for (int i = 0; i < numEvents; ++i)
+            spawnGrain(incoming[(size_t) i], sampleRate, numLanes);
+    
+    // Nothing to redraw once the last grain has faded and none has started
+    return wasActive || hasVisibleGrains();
 }
 
-void GrainVisualizer::updateGrainActivity(float density, float size, bool reverse)
+void GrainVisualizer::showingChanged(bool isShowing)
 {
-    currentDensity = density;
-    currentSize = size;
-    currentReverse = reverse;
+    // Onsets queued while hidden are history, not a burst to replay
+    if (isShowing)
+        audioProcessor.grainEvents.discardPending();
 }
 
-void GrainVisualizer::updateGrains()
+bool GrainVisualizer::hasVisibleGrains() const
+{
+    return std::any_of(visualGrains.begin(), visualGrains.end(),
+                       [](const VisualGrain& grain) { return grain.opacity > 0.0f; });
+}
+
+void GrainVisualizer::spawnGrain(const GrainEvent& event, double sampleRate, int numLanes)
 {
-    auto bounds = getLocalBounds().reduced(20);
+    // Drop the onset if every particle is still alight
+    auto slot = std::find_if(visualGrains.begin(), visualGrains.end(),
+                             [](const VisualGrain& grain) { return grain.opacity <= 0.0f; });
+    if (slot == visualGrains.end())
+        return;
     
-    for (auto& grain : visualGrains)
-    {
-        if (grain.opacity > 0.0f)
-        {
-            grain.age += 0.033f;
-            grain.opacity = juce::jmax(0.0f, 1.0f - grain.age * 2.0f);
-            
-            grain.x += (random.nextFloat() - 0.5f) * 0.5f;
-            grain.y += (random.nextFloat() - 0.5f) * 0.5f;
-            
-            grain.x = juce::jlimit((float)bounds.getX(), (float)bounds.getRight(), grain.x);
-            grain.y = juce::jlimit((float)bounds.getY(), (float)bounds.getBottom(), grain.y);
-        }
-    }
+    auto bounds = getLocalBounds().reduced(20).toFloat();
+    auto& grain = *slot;
     
-    float spawnProbability = currentDensity * 0.1f;
+    // x: how far back the grain reads, 1 ms at the right edge to 1 s at the
+    // left on a log scale. y: one lane per channel.
+    const float lagSeconds = juce::jlimit(0.001f, 1.0f, static_cast<float>(event.startLag / sampleRate));
+    const float lane = bounds.getHeight() / numLanes;
+    grain.x = bounds.getRight() - std::log10(lagSeconds * 1000.0f) / 3.0f * bounds.getWidth();
+    grain.y = bounds.getY() + lane * (juce::jmin<int>(event.channel, numLanes - 1) + 0.2f + 0.6f * random.nextFloat());
     
-    if (random.nextFloat() < spawnProbability)
+    // Bigger, longer-lived particles for longer grains; brighter for louder ones
+    const float durationSeconds = static_cast<float>(event.size / sampleRate);
+    grain.size = juce::jmap(juce::jlimit(5.0f, 200.0f, durationSeconds * 1000.0f), 5.0f, 200.0f, 2.0f, 8.0f);
+    grain.lifetime = juce::jmax(minLifetime, durationSeconds);
+    grain.peakOpacity = 0.3f + 0.7f * juce::jlimit(0.0f, 1.0f, event.amplitude);
+    grain.opacity = grain.peakOpacity;
+    grain.age = 0.0f;
+    grain.isReverse = event.isReverse;
+    grain.color = grain.isReverse ? juce::Colour(0xff4ecdc4) : juce::Colour(0xff64c896);
+}
+
+void GrainVisualizer::updateGrains()
+{
+    // Fade each particle out over its grain's lifetime
+    for (auto& grain : visualGrains)
     {
-        for (auto& grain : visualGrains)
+        if (grain.opacity > 0.0f)
         {
-            if (grain.opacity <= 0.0f)
-            {
-                grain.x = bounds.getX() + random.nextFloat() * bounds.getWidth();
-                grain.y = bounds.getY() + random.nextFloat() * bounds.getHeight();
-                grain.size = juce::jmap(currentSize, 5.0f, 200.0f, 2.0f, 8.0f);
-                grain.opacity = 0.8f + random.nextFloat() * 0.2f;
-                grain.age = 0.0f;
-                grain.isReverse = currentReverse;
-                
-                if (grain.isReverse)
-                {
-                    grain.color = juce::Colour(0xff4ecdc4);
-                }
-                else
-                {
-                    grain.color = juce::Colour(0xff64c896);
-                }
-                
-                break;
-            }
+            grain.age += static_cast<float>(1.0 / frameRate);
+            grain.opacity = grain.peakOpacity * juce::jmax(0.0f, 1.0f - grain.age / grain.lifetime);
         }
     }
-}
\ No newline at end of file
+}
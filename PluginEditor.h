@@ -35,6 +35,74 @@ private:
     juce::Colour backgroundDark     = juce::Colour(0xff0d1a0d);
 };
 
+//==============================================================================
+// Opaque static artwork rendered once into an image and blitted on every
+// repaint. Re-rendered only when the bounds or the display scale change.
+//==============================================================================
+class CachedBackground
+{
+public:
+    explicit CachedBackground(std::function<void(juce::Graphics&)> painterToUse)
+        : painter(std::move(painterToUse)) {}
+    
+    void draw(juce::Graphics& g, juce::Rectangle<int> bounds);
+    
+private:
+    std::function<void(juce::Graphics&)> painter;
+    juce::Image image;
+    juce::Rectangle<int> imageBounds;
+    float imageScale = 0.0f;
+};
+
+//==============================================================================
+// Drives every animated component from the display's vertical blank.
+//
+// One callback per refresh walks the registered clients. Each advances at
+// most at its own rate and only while its component is showing, so a tab
+// that has been removed or a hidden editor costs nothing. Clients that report
+// a change are repainted from the same callback, which the peer coalesces
+// into a single paint pass per frame.
+//==============================================================================
+class FrameScheduler
+{
+public:
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+        
+        // Advances the animation by one frame; return true if the component
+        // needs repainting
+        virtual bool advanceFrame() = 0;
+        
+        // Called when the component starts or stops showing
+        virtual void showingChanged(bool /*isShowing*/) {}
+    };
+    
+    explicit FrameScheduler(juce::Component& host);
+    
+    // component is what gets checked for visibility and repainted. Clients
+    // must remove themselves before they are destroyed.
+    void add(Client& client, juce::Component& component, double framesPerSecond);
+    void remove(Client& client);
+    
+private:
+    struct Entry
+    {
+        Client* client;
+        juce::Component* component;
+        double interval;
+        double nextFrameTime;
+        bool wasShowing;
+    };
+    
+    void onVBlank();
+    
+    std::vector<Entry> entries;
+    juce::VBlankAttachment vblank;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameScheduler)
+};
 
 //==============================================================================
 // Custom Knob Component
@@ -124,34 +192,42 @@ private:
 //==============================================================================
 // Grain Visualizer Component
 //==============================================================================
-class GrainVisualizer : public juce::Component, public juce::Timer
+class GrainVisualizer : public juce::Component, private FrameScheduler::Client
 {
 public:
-    GrainVisualizer();
+    GrainVisualizer(MyPluginAudioProcessor& processor, FrameScheduler& scheduler);
     ~GrainVisualizer() override;
     
     void paint(juce::Graphics& g) override;
-    void timerCallback() override;
-    
-    void updateGrainActivity(float density, float size, bool reverse);
     
 private:
+    bool advanceFrame() override;
+    void showingChanged(bool isShowing) override;
+    
+    MyPluginAudioProcessor& audioProcessor;
+    FrameScheduler& frameScheduler;
+    
     struct VisualGrain {
         float x, y;
         float size;
         float opacity;
+        float peakOpacity;
         float age;
+        float lifetime;         // seconds: the grain's real duration, at least minLifetime
         bool isReverse;
         juce::Colour color;
     };
     
+    static constexpr double frameRate = 30.0;
+    static constexpr float minLifetime = 0.15f;
+    
     std::vector<VisualGrain> visualGrains;
-    juce::Random random;
-    float currentDensity = 1.0f;
-    float currentSize = 50.0f;
-    bool currentReverse = false;
+    std::array<GrainEvent, GrainEventQueue::capacity> incoming{};
+    juce::Random random; // only scatters grains within their channel's lane
     
+    void spawnGrain(const GrainEvent& event, double sampleRate, int numLanes);
     void updateGrains();
+    bool hasVisibleGrains() const;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GrainVisualizer)
 };
@@ -159,24 +235,112 @@ private:
 //==============================================================================
 // Real-time Waveform Display
 //==============================================================================
-class WaveformDisplay : public juce::Component, public juce::Timer
+class WaveformDisplay : public juce::Component, private FrameScheduler::Client
 {
 public:
-    WaveformDisplay(MyPluginAudioProcessor& processor);
+    WaveformDisplay(MyPluginAudioProcessor& processor, FrameScheduler& scheduler);
     ~WaveformDisplay() override;
     
     void paint(juce::Graphics& g) override;
-    void timerCallback() override;
     
 private:
+    bool advanceFrame() override;
+    void rebuildPaths();
+
     MyPluginAudioProcessor& audioProcessor;
-    juce::Path waveformPath;
-    std::array<float, 512> displayBuffer{};
-    bool needsRepaint = false;
+    FrameScheduler& frameScheduler;
+
+    // Most recent frames, oldest first once historyWrite wraps
+    static constexpr int historySize = 512;
+    std::array<ScopeFrame, historySize> history{};
+    std::array<ScopeFrame, ScopeFifo::capacity> incoming{};
+    int historyWrite = 0;
+
+    juce::Path inputPath, outputPath, rmsPath;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformDisplay)
 };
 
+//==============================================================================
+// Delay Memory Display
+//==============================================================================
+class DelayMemoryDisplay : public juce::Component, private FrameScheduler::Client
+{
+public:
+    DelayMemoryDisplay(MyPluginAudioProcessor& processor, FrameScheduler& scheduler);
+    ~DelayMemoryDisplay() override;
+    
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
+    void mouseDoubleClick(const juce::MouseEvent& event) override;
+    
+private:
+    bool advanceFrame() override;
+    void rebuildPaths();
+
+    MyPluginAudioProcessor& audioProcessor;
+    FrameScheduler& frameScheduler;
+
+    // Fraction of the ring on screen, ending at the write head
+    static constexpr float minZoom = 1.0f / 256.0f;
+    float zoom = 1.0f;
+
+    // Peak range per pixel column, sized in resized() so frames don't allocate
+    std::vector<juce::Range<float>> columns;
+    std::array<int, PeakPyramid::maxGrainMarkers> grainPositions{};
+    int lastWriteHead = -1;
+    juce::Path peakPath, grainPath;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DelayMemoryDisplay)
+};
+
+//==============================================================================
+// Spectrum Display
+//==============================================================================
+class SpectrumDisplay : public juce::Component, private FrameScheduler::Client
+{
+public:
+    SpectrumDisplay(MyPluginAudioProcessor& processor, FrameScheduler& scheduler);
+    ~SpectrumDisplay() override;
+    
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    
+private:
+    bool advanceFrame() override;
+    void showingChanged(bool isShowing) override;
+    void rebuildPaths();
+    juce::Rectangle<float> getPlotArea() const;
+    float xForFrequency(float hz) const;
+    float yForDecibels(float decibels) const;
+
+    MyPluginAudioProcessor& audioProcessor;
+    FrameScheduler& frameScheduler;
+
+    // Owns the worker thread; it only analyses while this display is showing
+    SpectrumAnalyser analyser;
+    SpectrumAnalyser::Spectrum spectrum;
+
+    static constexpr float minFrequency = 20.0f, maxFrequency = 20000.0f;
+    static constexpr float maxDecibels = 12.0f;
+
+    juce::ComboBox fftSizeBox;
+    juce::ComboBox averagingBox;
+    juce::ToggleButton peakHoldButton;
+
+    // Filter parameters the curve follows, resolved once from Params::table,
+    // and the raw values it was last drawn for
+    static constexpr std::array<Params::ID, 4> filterParamIds { Params::filterEnabled, Params::filterCutoff,
+                                                                Params::filterResonance, Params::filterType };
+    std::array<std::atomic<float>*, 4> filterParams{};
+    std::array<float, 4> filterSettings{};
+    
+    juce::Path inputPath, outputPath, peakPath, filterPath;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumDisplay)
+};
+
 //==============================================================================
 // Filter Section Component
 //==============================================================================
@@ -197,6 +361,8 @@ private:
     
     juce::ComboBox filterTypeBox;
     juce::Label filterTypeLabel;
+    juce::ToggleButton filterEnabledButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> filterEnabledAttachment;
     juce::AudioProcessorValueTreeState& valueTreeState;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FilterSection)
@@ -219,6 +385,12 @@ public:
 private:
     std::unique_ptr<CustomKnob> semitonesKnob;
     std::unique_ptr<CustomKnob> octavesKnob;
+    std::unique_ptr<CustomKnob> mixKnob;
+    
+    juce::ComboBox modeBox, fftSizeBox, overlapBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> modeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> fftSizeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> overlapAttachment;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PitchSection)
 };
@@ -250,6 +422,7 @@ private:
     
     // Pan control
     std::unique_ptr<CustomKnob> panKnob;
+    juce::ComboBox panModeBox;
     
     // Attachments
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> lfoTargetAttachment;
@@ -257,6 +430,7 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> lfoBipolarAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> lfoSyncAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> lfoSyncDivisionAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> panModeAttachment;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LfoPanSection)
 };
@@ -310,20 +484,20 @@ private:
 //==============================================================================
 // Main Tab Component
 //==============================================================================
-class MainTabComponent : public juce::Component, public juce::Timer
+class MainTabComponent : public juce::Component
 {
 public:
-    MainTabComponent(MyPluginAudioProcessor& processor);
+    MainTabComponent(MyPluginAudioProcessor& processor, FrameScheduler& scheduler);
     ~MainTabComponent() override;
     
     void paint(juce::Graphics& g) override;
     void resized() override;
-    void timerCallback() override;
     
     std::function<void(const juce::String&)> onStatusUpdate;
     
 private:
     MyPluginAudioProcessor& audioProcessor;
+    FrameScheduler& frameScheduler;
     
     // UI Components
     std::unique_ptr<PresetComboBox> presetSelector;
@@ -342,11 +516,36 @@ private:
     juce::Slider mixSlider;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> mixAttachment;
     
+    // Grain window shape
+    juce::ComboBox grainWindowBox;
+    juce::Label grainWindowLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> grainWindowAttachment;
+    
+    // Feedback EQ slope
+    juce::ComboBox eqSlopeBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> eqSlopeAttachment;
+    
+    // Feedback saturation character
+    juce::ComboBox saturationBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> saturationAttachment;
+    juce::ComboBox oversamplingBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
+    
+    // High-density grain mode
+    juce::ToggleButton swarmButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> swarmAttachment;
+    
+    // Random per-grain detune
+    juce::ToggleButton detuneButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> detuneAttachment;
+    
     void setupControls();
     void setupSections();
     void drawWaterfallBackground(juce::Graphics& g);
     void drawCosmicStreaks(juce::Graphics& g, juce::Rectangle<int> bounds);
     
+    CachedBackground background { [this](juce::Graphics& g) { drawWaterfallBackground(g); } };
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainTabComponent)
 };
 
@@ -356,7 +555,7 @@ private:
 class AdvancedTabComponent : public juce::Component
 {
 public:
-    AdvancedTabComponent(MyPluginAudioProcessor& processor);
+    AdvancedTabComponent(MyPluginAudioProcessor& processor, FrameScheduler& scheduler);
     ~AdvancedTabComponent() override;
     
     void paint(juce::Graphics& g) override;
@@ -369,6 +568,8 @@ private:
     
     // Sections
     std::unique_ptr<WaveformDisplay> waveformDisplay;
+    std::unique_ptr<DelayMemoryDisplay> delayMemoryDisplay;
+    std::unique_ptr<SpectrumDisplay> spectrumDisplay;
     std::unique_ptr<FilterSection> filterSection;
     std::unique_ptr<PitchSection> pitchSection;
     std::unique_ptr<LfoPanSection> lfoPanSection;
@@ -377,6 +578,8 @@ private:
     
     void drawWaterfallBackground(juce::Graphics& g);
     
+    CachedBackground background { [this](juce::Graphics& g) { drawWaterfallBackground(g); } };
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AdvancedTabComponent)
 };
 
@@ -403,6 +606,9 @@ private:
     juce::TextButton advancedTabButton;
     bool isMainTabActive = true;
     
+    // Animates every visualiser; declared before the tabs so it outlives them
+    FrameScheduler frameScheduler { *this };
+    
     // Tab components
     std::unique_ptr<MainTabComponent> mainTab;
     std::unique_ptr<AdvancedTabComponent> advancedTab;
@@ -410,7 +616,10 @@ private:
     // Status display
     juce::Label statusLabel;
     
+    CachedBackground background { [this](juce::Graphics& g) { drawBackground(g); } };
+    
     void updateStatusText(const juce::String& text);
+    void drawBackground(juce::Graphics& g);
     void drawCosmicStreaks(juce::Graphics& g, juce::Rectangle<int> bounds);
     void switchToMainTab();
     void switchToAdvancedTab();
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
@@ -8,16 +9,23 @@ MyPluginAudioProcessor::MyPluginAudioProcessor()
     .withOutput ("Output", juce::AudioChannelSet::stereo(), true)),
   valueTreeState (*this, nullptr, "PARAMS", createParameterLayout())
 {
-    // Initialize pitch smoothers
-    for (auto& smoother : pitchSmoother)
-        smoother.reset(44100.0);
-        
+    for (const auto& spec : Params::table)
+    {
+        rawParams[spec.index] = valueTreeState.getRawParameterValue(spec.id);
+        jassert(rawParams[spec.index] != nullptr);
+    }
+
+    for (const auto id : latencyParams)
+        valueTreeState.addParameterListener(Params::table[id].id, this);
+
     // Initialize flanger feedback smoothers  
     flangerFeedbackSmoother.setCurrentAndTargetValue(0.0f);
-        
-    // Initialize pan smoothers
-    for (auto& smoother : panSmoother)
-        smoother.reset(44100.0);
+}
+
+MyPluginAudioProcessor::~MyPluginAudioProcessor()
+{
+    for (const auto id : latencyParams)
+        valueTreeState.removeParameterListener(Params::table[id].id, this);
 }
 
 juce::AudioProcessorEditor* MyPluginAudioProcessor::createEditor()
@@ -30,17 +38,29 @@ void MyPluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
     currentSampleRate = sampleRate;
     currentBufferSize = samplesPerBlock;
     
+    grainWindowTable.build();
+
+    const int numChannels = getTotalNumOutputChannels();
+    const bool useDouble = isUsingDoublePrecision();
+    floatScratch.prepare({ 1, 1, PitchShifter::numTapScratchChannels, useDouble ? numChannels : 0 }, samplesPerBlock);
+
     // Prepare existing delay buffers
-    for (auto ch = 0; ch < getTotalNumOutputChannels(); ++ch)
-    {
-        delayBuffers[ch].assign(maxDelayTime, 0.0f);
-        delayWriteIndex[ch] = 0;
-        highCutState[ch] = 0.0f;
-        lowCutState[ch] = 0.0f;
-        grainTriggerCountdown[ch] = 0;
+    // Pitched-up grains start further back by the extra ring they consume
+    const int grainHeadroom = static_cast<int>(maxGrainSamples * (1.0f + maxGrainRate)) + swarmRunLength;
+    delayBufferSize = juce::nextPowerOfTwo(static_cast<int>(std::ceil(sampleRate * maxDelayMs / 1000.0)) + grainHeadroom);
+    delayMask = delayBufferSize - 1;
 
-        for (auto& g : activeGrains[ch]) g = Grain{};
-    }
+    // Sleep only after a full ring's worth of quiet, so nothing audible is left in it
+    silenceDetector.prepare(delayBufferSize);
+    delayPeaks.prepare(delayBufferSize);
+
+    // One ring, grain engine and trigger state per output channel
+    numDelayChannels = numChannels;
+    delayWriteIndex.assign(static_cast<size_t>(numChannels), 0);
+    grainTriggerCountdown.assign(static_cast<size_t>(numChannels), 0);
+    swarmNextOnset.assign(static_cast<size_t>(numChannels), 0.0f);
+
+    buildCrossFeedPolicy(numChannels);
     
     // Prepare DSP chain
     juce::dsp::ProcessSpec spec;
@@ -48,10 +68,6 @@ void MyPluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
     spec.maximumBlockSize = samplesPerBlock;
     spec.numChannels = getTotalNumOutputChannels();
     
-    // State Variable Filter
-    stateVariableFilter.prepare(spec);
-    stateVariableFilter.reset();
-    
     // Chorus
     chorus.prepare(spec);
     chorus.reset();
@@ -61,28 +77,113 @@ void MyPluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
     flanger.reset();
     flangerFeedbackSmoother.reset(sampleRate, 0.02f);
     flangerFeedbackSmoother.setCurrentAndTargetValue(0.0f);
-    // Initialize pitch buffers
-    for (auto ch = 0; ch < getTotalNumOutputChannels(); ++ch)
+    
+    // Pitch shifters
+    const auto params = readParamSnapshot();
+    pitchShifter.prepare(sampleRate, numChannels, floatScratch.getArrayOfWritePointers(pitchTapScratch));
+    phaseVocoder.prepare(numChannels);
+    phaseVocoder.setConfiguration(params.pitchFftSize, params.pitchOverlap);
+    activePitchMode = params.pitchMode;
+    
+    panStage.prepare(sampleRate, floatScratch.getWritePointer(panScratch, 0));
+    
+    // Reset LFO
+    lfoState.phase = 0.0f;
+    
+    for (auto& bypass : stageBypass)
+        bypass.prepare(sampleRate);
+
+    // Only the precision the host will process in holds audio state
+    if (useDouble)
     {
-        pitchBuffer[ch].assign(8192, 0.0f); // Buffer for pitch shifting
-        pitchWriteIndex[ch] = 0;
+        prepareSampleState<double>(sampleRate, samplesPerBlock, numChannels);
+        floatState.release();
     }
-    
-    // Initialize smoothed values
-    for (auto& smoother : pitchSmoother)
+    else
     {
-        smoother.reset(sampleRate, 0.05); // 50ms smoothing
-        smoother.setCurrentAndTargetValue(1.0f);
+        prepareSampleState<float>(sampleRate, samplesPerBlock, numChannels);
+        doubleState.release();
     }
-    
-    for (auto& smoother : panSmoother)
+
+    updateLatency();
+}
+
+template <typename SampleType>
+void MyPluginAudioProcessor::prepareSampleState(double sampleRate, int samplesPerBlock, int numChannels)
+{
+    auto& state = getState<SampleType>();
+
+    state.scratch.prepare({ numChannels, 1, 1, numChannels, numChannels }, samplesPerBlock);
+    state.feedbackEq.prepare(sampleRate, numChannels);
+
+    state.feedbackSaturator.prepare(numChannels, samplesPerBlock);
+    state.feedbackSaturator.setFactor(static_cast<int>(rawParams[Params::oversampling]->load()));
+
+    state.delayMemory.assign(static_cast<size_t>(numChannels) * static_cast<size_t>(delayBufferSize), SampleType(0));
+    state.grainEngines = std::vector<GrainEngine<SampleType>>(static_cast<size_t>(numChannels));
+
+    for (auto& engine : state.grainEngines)
+        engine.prepare(state.scratch.getWritePointer(grainEnvelopeScratch, 0),
+                       state.scratch.getWritePointer(grainGatherScratch, 0),
+                       grainWindowTable, swarmMaxGrains);
+
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = samplesPerBlock;
+    spec.numChannels = numChannels;
+
+    // State Variable Filter
+    state.filter.prepare(spec);
+    state.filter.reset();
+}
+
+void MyPluginAudioProcessor::buildCrossFeedPolicy(int numChannels)
+{
+    // Width cross-feed only makes sense between mirror-image speakers, so each
+    // left/right pair in the layout borrows from its partner, with the left
+    // side reading a little less far back than the right. Centre, LFE and
+    // ambisonic channels are left alone; discrete layouts pair neighbours.
+    using CT = juce::AudioChannelSet::ChannelType;
+    static constexpr std::pair<CT, CT> mirrorPairs[] = {
+        { CT::left, CT::right },
+        { CT::leftSurround, CT::rightSurround },
+        { CT::leftSurroundSide, CT::rightSurroundSide },
+        { CT::leftSurroundRear, CT::rightSurroundRear },
+        { CT::leftCentre, CT::rightCentre },
+        { CT::wideLeft, CT::wideRight },
+        { CT::topFrontLeft, CT::topFrontRight },
+        { CT::topSideLeft, CT::topSideRight },
+        { CT::topRearLeft, CT::topRearRight }
+    };
+
+    crossFeedPartner.assign(static_cast<size_t>(numChannels), -1);
+    crossFeedDelayFactor.assign(static_cast<size_t>(numChannels), 0.0f);
+
+    auto link = [this, numChannels](int first, int second)
     {
-        smoother.reset(sampleRate, 0.05);
-        smoother.setCurrentAndTargetValue(0.0f); // Center pan
+        if (first < 0 || second < 0 || first >= numChannels || second >= numChannels)
+            return;
+
+        crossFeedPartner[(size_t) first] = second;
+        crossFeedPartner[(size_t) second] = first;
+        crossFeedDelayFactor[(size_t) first] = 0.7f;
+        crossFeedDelayFactor[(size_t) second] = 0.8f;
+    };
+
+    const auto layout = getChannelLayoutOfBus(false, 0);
+
+    if (layout.getAmbisonicOrder() >= 0)
+        return;
+
+    if (layout.isDiscreteLayout())
+    {
+        for (int channel = 0; channel + 1 < numChannels; channel += 2)
+            link(channel, channel + 1);
+        return;
     }
-    
-    // Reset LFO
-    lfoState.phase = 0.0f;
+
+    for (const auto& pair : mirrorPairs)
+        link(layout.getChannelIndexForType(pair.first), layout.getChannelIndexForType(pair.second));
 }
 
 void MyPluginAudioProcessor::releaseResources()
@@ -92,10 +193,22 @@ void MyPluginAudioProcessor::releaseResources()
 
 bool MyPluginAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    return layouts.getMainInputChannelSet() == layouts.getMainOutputChannelSet();
+    return layouts.getMainInputChannelSet() == layouts.getMainOutputChannelSet()
+        && layouts.getMainOutputChannelSet().size() <= maxChannels;
+}
+
+void MyPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    processBlockInternal(buffer);
 }
 
-void MyPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+void MyPluginAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    processBlockInternal(buffer);
+}
+
+template <typename SampleType>
+void MyPluginAudioProcessor::processBlockInternal(juce::AudioBuffer<SampleType>& buffer)
 {
     juce::ScopedNoDenormals noDenormals;
 
@@ -103,122 +216,549 @@ void MyPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
     for (int i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    const int numSamples = buffer.getNumSamples();
+    auto& state = getState<SampleType>();
+    const int maxBlockSize = state.scratch.getMaxBlockSize();
+
+    if (maxBlockSize == 0)
+        return; // not prepared yet, or prepared for the other precision
+
+    const auto params = readParamSnapshot();
+    const int numChannels = buffer.getNumChannels();
+    int startSample = 0;
+
+    // === SLEEP ===
+    // While asleep nothing runs until the input becomes audible; the chain then
+    // resumes on exactly that sample.
+    if (silenceDetector.isSleeping())
+    {
+        const int firstAudible = SilenceDetector::findFirstAudible(buffer, numChannels);
+        if (firstAudible < 0)
+        {
+            buffer.clear();
+            scopeFifo.push({}); // keep the scope and analyser moving through the silence
+            inputSpectrum.push(buffer, numChannels);
+            outputSpectrum.push(buffer, numChannels);
+            return;
+        }
+
+        silenceDetector.wake();
+        for (int channel = 0; channel < numChannels; ++channel)
+            buffer.clear(channel, 0, firstAudible);
+        startSample = firstAudible;
+    }
+
+    const bool inputIsQuiet = SilenceDetector::isQuiet(buffer, numChannels);
+
+    // The delay output has to be quiet too, even when the mix hides it. The
+    // wet scratch only holds the latest slice, so each slice is checked.
+    bool delayIsQuiet = true;
+    auto runChain = [&](juce::AudioBuffer<SampleType>& target)
+    {
+        processChain(target, params);
+
+        const auto wet = state.scratch.getBuffer(granularWetScratch, target.getNumSamples());
+        delayIsQuiet = delayIsQuiet && SilenceDetector::isQuiet(wet, juce::jmin(numChannels, wet.getNumChannels()));
+    };
+
+    if (startSample == 0 && numSamples <= maxBlockSize)
+    {
+        runChain(buffer);
+    }
+    else
+    {
+        // Some hosts send more than they announced in prepareToPlay. Rather than
+        // resizing anything here, run the chain over prepared-size slices; each slice
+        // refers to the host's channel memory, so nothing is allocated or copied.
+        for (int start = startSample; start < numSamples; start += maxBlockSize)
+        {
+            juce::AudioBuffer<SampleType> slice(buffer.getArrayOfWritePointers(), numChannels, start,
+                                                juce::jmin(maxBlockSize, numSamples - start));
+            runChain(slice);
+        }
+    }
+
+    silenceDetector.update(inputIsQuiet && delayIsQuiet && SilenceDetector::isQuiet(buffer, numChannels), numSamples);
+}
+
+double MyPluginAudioProcessor::getTailLengthSeconds() const
+{
+    const double sampleRate = getSampleRate();
+    if (sampleRate <= 0.0 || delayBufferSize == 0)
+        return 0.0;
+
+    const auto params = readParamSnapshot();
+
+    // Time for a loop that scales the level by gain on every trip of
+    // periodSeconds to fall below the silence threshold
+    auto decayTime = [](double periodSeconds, double gain)
+    {
+        if (gain <= 0.0)
+            return periodSeconds;
+
+        const double repeats = std::ceil(std::log(static_cast<double>(SilenceDetector::threshold)) / std::log(gain));
+        return periodSeconds * (repeats + 1.0);
+    };
+
+    // One trip round the feedback loop lasts as long as the oldest ring slot
+    // the loop reads. Without grains that is the delay time. Grains read at
+    // most triggerNewGrain's lag at full spray (or the swarm minimum lag) plus
+    // the ring they cover while playing.
+    double periodSamples = juce::jlimit(1.0, delayBufferSize - 1.0, params.delayTimeMs * sampleRate / 1000.0);
+
+    if (params.grainDensity > 0.1f)
+    {
+        const double grainSize = juce::jlimit(64.0, 8192.0, params.grainSizeMs * sampleRate / 1000.0);
+        const double maxSize = juce::jmin(static_cast<double>(maxGrainSamples), grainSize * (1.0 + params.randomization * 0.5));
+        const double maxSemitones = std::abs(params.grainPitch) + (params.grainDetune ? params.randomization : 0.0f);
+        const double maxRate = juce::jlimit(1.0, static_cast<double>(maxGrainRate), std::exp2(maxSemitones / 12.0));
+
+        double longestLag = grainSize * (1.0 + params.grainSpray);
+        if (params.swarmMode)
+            longestLag = juce::jmax(longestLag, swarmRunLength + maxSize);
+
+        periodSamples = longestLag + maxSize * maxRate;
+    }
+
+    double tail = decayTime(periodSamples / sampleRate, params.feedback);
+
+    if (params.stereoWidth > 0.0f && !crossFeedDelayFactor.empty())
+    {
+        const double crossDelay = params.delayTimeMs * sampleRate / 1000.0
+                                * *std::max_element(crossFeedDelayFactor.begin(), crossFeedDelayFactor.end());
+        tail += crossDelay / sampleRate;
+    }
+
+    // The stages after the loop ring on past it. The filter decays with a time
+    // constant of Q / (pi * cutoff); the chorus and flanger repeat at their
+    // longest modulated delay (centre plus 20 ms at full depth).
+    if (params.filterEnabled)
+    {
+        const float lowestCutoff = params.lfoTarget == ParamSnapshot::lfoToCutoff
+                                 ? juce::jmax(0.0f, params.filterCutoff - params.lfoDepth) : params.filterCutoff;
+        const double timeConstant = ParamSnapshot::filterResonanceToQ(params.filterResonance)
+                                  / (juce::MathConstants<double>::pi * ParamSnapshot::filterCutoffToHz(lowestCutoff));
+        tail += timeConstant * -std::log(static_cast<double>(SilenceDetector::threshold));
+    }
+
+    if (std::abs(params.pitchSemitones + params.pitchOctaves * 12.0f) >= 0.1f && params.pitchMix > 0.0f)
+        tail += PitchShifter::windowSeconds;
+
+    if (params.chorusMix > 0.0f)
+        tail += decayTime((5.0 + 20.0 * params.chorusDepth / 100.0) / 1000.0, 0.3);
+
+    if (params.flangerMix > 0.0f)
+    {
+        const double centreMs = juce::jmap(params.flangerDelay, 0.0f, 100.0f, 0.1f, 10.0f);
+        const double depth = juce::jmin(1.0f, juce::jmap(params.flangerDepth, 0.0f, 100.0f, 0.0f, 5.0f));
+        tail += decayTime((centreMs + 20.0 * depth) / 1000.0, params.flangerFeedback / 100.0);
+    }
+
+    // Everything comes out the reported latency late
+    return tail + getLatencySamples() / sampleRate;
+}
+
+ParamSnapshot MyPluginAudioProcessor::readParamSnapshot() const
+{
+    auto get = [this](Params::ID id) { return rawParams[id]->load(std::memory_order_relaxed); };
+    auto isOn = [&get](Params::ID id) { return get(id) > 0.5f; };
+
+    ParamSnapshot p;
+
+    p.delayTimeMs = get(Params::delayTime);
+    p.feedback = get(Params::feedback);
+    p.mix = get(Params::mix) / 100.0f;
+    p.grainSizeMs = get(Params::grainSize);
+    p.grainDensity = get(Params::grainDensity);
+    p.grainSpray = get(Params::grainSpray) / 100.0f;
+    p.reverseGrains = isOn(Params::reverseGrains);
+    p.randomization = get(Params::randomization) / 100.0f;
+    p.grainWindow = static_cast<int>(get(Params::grainWindow));
+    p.swarmMode = isOn(Params::swarmMode);
+    p.grainPitch = get(Params::grainPitch);
+    p.grainDetune = isOn(Params::grainDetune);
+    p.stereoWidth = get(Params::stereoWidth) / 100.0f;
+    p.eqHigh = get(Params::eqHigh);
+    p.eqLow = get(Params::eqLow);
+    p.eqSlope = static_cast<int>(get(Params::eqSlope));
+    p.saturation = static_cast<int>(get(Params::saturation));
+    p.oversampling = static_cast<int>(get(Params::oversampling));
+
+    p.filterEnabled = isOn(Params::filterEnabled);
+    p.filterCutoff = get(Params::filterCutoff);
+    p.filterResonance = get(Params::filterResonance);
+    p.filterMode = ParamSnapshot::filterTypeToMode(get(Params::filterType));
+
+    p.pitchSemitones = get(Params::pitchSemitones);
+    p.pitchOctaves = get(Params::pitchOctaves);
+    p.pitchMix = get(Params::pitchMix) / 100.0f;
+    p.pitchMode = static_cast<int>(get(Params::pitchMode));
+    p.pitchFftSize = static_cast<int>(get(Params::pitchFftSize));
+    p.pitchOverlap = static_cast<int>(get(Params::pitchOverlap));
+    p.panPosition = get(Params::panPosition);
+    p.panMode = static_cast<int>(get(Params::panMode));
+
+    p.lfoRate = get(Params::lfoRate);
+    p.lfoDepth = get(Params::lfoDepth);
+    p.lfoTarget = get(Params::lfoTarget) > 50.0f ? ParamSnapshot::lfoToPan : ParamSnapshot::lfoToCutoff;
+    p.lfoBipolar = isOn(Params::lfoBipolar);
+    p.lfoWaveform = get(Params::lfoWaveform) > 50.0f ? ParamSnapshot::lfoTriangle : ParamSnapshot::lfoSine;
+    p.lfoTempoSync = isOn(Params::lfoTempoSync);
+    p.lfoSyncDivision = juce::roundToInt(get(Params::lfoSyncDivision));
+
+    p.chorusRate = get(Params::chorusRate);
+    p.chorusDepth = get(Params::chorusDepth);
+    p.chorusMix = get(Params::chorusMix) / 100.0f;
+
+    p.flangerDelay = get(Params::flangerDelay);
+    p.flangerFeedback = get(Params::flangerFeedback);
+    p.flangerDepth = get(Params::flangerDepth);
+    p.flangerRate = get(Params::flangerRate);
+    p.flangerMix = get(Params::flangerMix) / 100.0f;
+
+    return p;
+}
+
+template <typename SampleType>
+void MyPluginAudioProcessor::processChain(juce::AudioBuffer<SampleType>& buffer, const ParamSnapshot& params)
+{
+    ScopeFrame scopeFrame;
+    scopeFrame.input = ScopeFrame::Level::measure(buffer, buffer.getNumChannels());
+    inputSpectrum.push(buffer, buffer.getNumChannels());
+
     // === ORIGINAL GRANULAR DELAY PROCESSING ===
+    GranularParams granular;
+    granular.feedback = params.feedback;
+    granular.mix = params.mix;
+    granular.grainDensity = params.grainDensity;
+    granular.grainSpray = params.grainSpray;
+    granular.stereoWidth = params.stereoWidth;
+    granular.eqHigh = params.eqHigh;
+    granular.eqLow = params.eqLow;
+    granular.eqSlope = params.eqSlope;
+    granular.saturation = params.saturation;
+    granular.reverseGrains = params.reverseGrains;
+    granular.randomization = params.randomization;
+    granular.grainWindow = params.grainWindow;
+    granular.grainPitch = params.grainPitch;
+    granular.grainDetune = params.grainDetune;
+    granular.swarmMode = params.swarmMode;
+
+    granular.delaySamples = juce::jlimit(1, delayBufferSize - 1,
+        static_cast<int>(params.delayTimeMs * getSampleRate() / 1000.0f));
+
+    int grainSizeSamples = static_cast<int>(params.grainSizeMs * getSampleRate() / 1000.0f);
+    granular.grainSizeSamples = juce::jlimit(64, 8192, grainSizeSamples);
+
+    // Dense swarms sum hundreds of uncorrelated grains, so scale each one by
+    // 1/sqrt(expected overlap) to keep the level in line with normal mode
+    if (granular.swarmMode)
+        granular.grainGain = 1.0f / std::sqrt(juce::jmax(1.0f, 2.0f * granular.grainDensity * swarmDensityScale));
+
+    auto& feedbackSaturator = getState<SampleType>().feedbackSaturator;
+    feedbackSaturator.setFactor(params.oversampling);
+    granular.feedbackLatency = feedbackSaturator.getLatencySamples();
+
+    processGranularDelay(buffer, granular);
+
+    // === NEW ADVANCED PROCESSING ===
+    updateLFO(params, buffer.getNumSamples());
+    
+    // Chorus, flanger and pan keep moving for their 50 ms mix/pan ramps after
+    // going neutral; the filter and pitch shifter just fade out.
+    const int rampTail = static_cast<int>(currentSampleRate * 0.05);
+    const bool panIsNeutral = params.panMode == PanStage::balance && params.panPosition == 0.0f
+                           && !(params.lfoTarget == ParamSnapshot::lfoToPan && params.lfoDepth > 0.0f);
+    
+    runFxStage(fxFilter, buffer, params.filterEnabled, 0,
+               [&](auto& b) { processFilter(b, params); },
+               [&] { getState<SampleType>().filter.reset(); });
+    // The phase vocoder delays everything that passes through it, so in that
+    // mode the stage stays in the chain to keep the reported latency constant
+    const bool pitchIsShifting = std::abs(params.pitchSemitones + params.pitchOctaves * 12.0f) >= 0.1f && params.pitchMix > 0.0f;
+    runFxStage(fxPitch, buffer, pitchIsShifting || params.pitchMode == PhaseVocoder::spectral, 0,
+               [&](auto& b) { processInFloat(b, [&](auto& f) { processPitchShift(f, params); }); },
+               [&] { pitchShifter.reset(); phaseVocoder.reset(); });
+    runFxStage(fxChorus, buffer, params.chorusMix > 0.0f, rampTail,
+               [&](auto& b) { processInFloat(b, [&](auto& f) { processChorus(f, params); }); },
+               [&] { chorus.reset(); });
+    runFxStage(fxFlanger, buffer, params.flangerMix > 0.0f, rampTail,
+               [&](auto& b) { processInFloat(b, [&](auto& f) { processFlanger(f, params); }); },
+               [&] { flanger.reset(); });
+    runFxStage(fxPan, buffer, !panIsNeutral, rampTail,
+               [&](auto& b) { processPanning(b, params); },
+               [&] { panStage.reset(); });
     
-    // Read parameter values  
-    const float delayTime = *valueTreeState.getRawParameterValue("delayTime");
-    const float feedback = *valueTreeState.getRawParameterValue("feedback");
-    const float mix = *valueTreeState.getRawParameterValue("mix") / 100.0f;
-    const float grainSize = *valueTreeState.getRawParameterValue("grainSize");
-    const float grainDensity = *valueTreeState.getRawParameterValue("grainDensity");
-    const float grainSpray = *valueTreeState.getRawParameterValue("grainSpray") / 100.0f;
-    const float stereoWidth = *valueTreeState.getRawParameterValue("stereoWidth") / 100.0f;
-    const float eqHigh = *valueTreeState.getRawParameterValue("eqHigh");
-    const float eqLow = *valueTreeState.getRawParameterValue("eqLow");
-    const bool reverseGrains = *valueTreeState.getRawParameterValue("reverseGrains") > 0.5f;
-    const float randomization = *valueTreeState.getRawParameterValue("randomization") / 100.0f;
-
-    // Create dry buffer for mixing
-    juce::AudioBuffer<float> dryBuffer;
-    dryBuffer.makeCopyOf(buffer);
-
-    // Process original granular delay
-    const int delaySamples = juce::jlimit(1, maxDelayTime - 1,
-        static_cast<int>(delayTime * getSampleRate() / 1000.0f));
-
-    int grainSizeSamples = static_cast<int>(grainSize * getSampleRate() / 1000.0f);
-    grainSizeSamples = juce::jlimit(64, 8192, grainSizeSamples);
-
-    // Process channels for granular delay
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    // Dropped if the editor isn't draining the queue
+    scopeFrame.output = ScopeFrame::Level::measure(buffer, buffer.getNumChannels());
+    scopeFifo.push(scopeFrame);
+    outputSpectrum.push(buffer, buffer.getNumChannels());
+}
+
+void MyPluginAudioProcessor::parameterChanged(const juce::String&, float)
+{
+    // May arrive on the audio thread, so the change is reported from the message thread
+    triggerAsyncUpdate();
+}
+
+void MyPluginAudioProcessor::handleAsyncUpdate()
+{
+    updateLatency();
+}
+
+void MyPluginAudioProcessor::updateLatency()
+{
+    // Only the phase vocoder delays the output; the feedback saturator's
+    // latency is taken up inside the loop
+    const auto params = readParamSnapshot();
+    const int latency = params.pitchMode == PhaseVocoder::spectral
+                      ? PhaseVocoder::getLatencySamples(params.pitchFftSize, params.pitchOverlap) : 0;
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+// === Advanced Processing Methods ===
+
+template <typename SampleType, typename ProcessFn, typename ResetFn>
+void MyPluginAudioProcessor::runFxStage(FxStage stage, juce::AudioBuffer<SampleType>& buffer, bool isActive, int tailSamples,
+                                        ProcessFn&& process, ResetFn&& reset)
+{
+    auto& bypass = stageBypass[stage];
+    bypass.update(isActive, tailSamples, buffer.getNumSamples());
+
+    if (bypass.isBypassed())
+        return;
+
+    if (bypass.needsReset())
+        reset();
+
+    if (!bypass.isFading())
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        auto* delayBuffer = delayBuffers[channel].data();
+        process(buffer);
+        return;
+    }
+
+    // Fading in or out: keep a dry copy and blend towards the processed signal
+    auto dry = getState<SampleType>().scratch.getBuffer(stageDryScratch, buffer.getNumSamples());
+    const int numChannels = juce::jmin(dry.getNumChannels(), buffer.getNumChannels());
+    for (int channel = 0; channel < numChannels; ++channel)
+        dry.copyFrom(channel, 0, buffer, channel, 0, buffer.getNumSamples());
+
+    process(buffer);
+    bypass.applyCrossfade(dry, buffer);
+}
+
+template <typename ProcessFn>
+void MyPluginAudioProcessor::processInFloat(juce::AudioBuffer<float>& buffer, ProcessFn&& process)
+{
+    process(buffer);
+}
+
+template <typename ProcessFn>
+void MyPluginAudioProcessor::processInFloat(juce::AudioBuffer<double>& buffer, ProcessFn&& process)
+{
+    // Pitch, chorus and flanger keep float state. In double precision they
+    // run on a float copy of the block, so only while one of them is active
+    // does the signal pass through float.
+    const int numSamples = buffer.getNumSamples();
+    auto floatBuffer = floatScratch.getBuffer(floatStageScratch, numSamples);
+    const int numChannels = juce::jmin(floatBuffer.getNumChannels(), buffer.getNumChannels());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* source = buffer.getReadPointer(channel);
+        std::copy(source, source + numSamples, floatBuffer.getWritePointer(channel));
+    }
+
+    process(floatBuffer);
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* processed = floatBuffer.getReadPointer(channel);
+        std::copy(processed, processed + numSamples, buffer.getWritePointer(channel));
+    }
+}
+
+template <typename SampleType>
+void MyPluginAudioProcessor::processGranularDelay(juce::AudioBuffer<SampleType>& buffer, const GranularParams& params)
+{
+    auto& state = getState<SampleType>();
+    auto& grainEngines = state.grainEngines;
+    const int numChannels = juce::jmin(buffer.getNumChannels(), numDelayChannels,
+                                       state.scratch.getNumChannels(granularWetScratch));
+    const int blockLength = buffer.getNumSamples();
+    const bool useGrains = params.grainDensity > 0.1f;
+
+    auto wetBuffer = state.scratch.getBuffer(granularWetScratch, blockLength);
+    wetBuffer.clear();
+
+    state.feedbackEq.setParameters(params.eqHigh, params.eqLow, params.eqSlope, blockLength);
+
+    // Each ring write lands feedbackLatency samples late, so every read below
+    // looks that much less far back and a trip round the loop keeps its length
+    const int latency = params.feedbackLatency;
+
+    // Work through the block in runs. A run ends before the next grain onset
+    // on any channel, and before any grain would read a ring slot that the
+    // feedback loop writes inside the run, so rendering grains for the whole
+    // run up front sounds the same as the old sample-by-sample loop.
+    for (int runStart = 0; runStart < blockLength;)
+    {
+        int runLength = blockLength - runStart;
+
+        if (useGrains && params.swarmMode)
         {
-            const float inputSample = channelData[sample];
-            float delayedSample = 0.0f;
+            // Fixed-length runs with every onset inside the run scheduled in
+            // one batch. Swarm grains always lag the write head by at least a
+            // run, so only grains left over from normal mode can shorten it.
+            runLength = juce::jmin(runLength, swarmRunLength);
 
-            // === GRANULAR PROCESSING ===
-            if (grainDensity > 0.1f)
+            for (int channel = 0; channel < numChannels; ++channel)
+                runLength = grainEngines[channel].getSafeRunLength(delayWriteIndex[channel], delayMask, runLength);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                grainEngines[channel].setGrainLimit(swarmMaxGrains);
+                scheduleSwarmGrains<SampleType>(channel, params, runLength);
+                grainEngines[channel].render(getDelayChannel<SampleType>(channel), delayMask,
+                                             wetBuffer.getWritePointer(channel, runStart), runLength);
+            }
+        }
+        else if (useGrains)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
             {
-                if (--grainTriggerCountdown[channel] <= 0)
+                grainEngines[channel].setGrainLimit(GrainEngine<SampleType>::defaultMaxGrains);
+
+                if (grainTriggerCountdown[channel] <= 1)
                 {
-                    triggerNewGrain(channel, grainSizeSamples, grainSpray, reverseGrains, randomization);
+                    triggerNewGrain<SampleType>(channel, params);
 
-                    const float densityFactor = juce::jmap(grainDensity, 0.1f, 4.0f, 0.1f, 4.0f);
-                    const int baseInterval = static_cast<int>(grainSizeSamples * 0.5f / densityFactor);
-                    const int randomVariation = static_cast<int>(baseInterval * randomization * (random.nextFloat() * 2.0f - 1.0f));
-                    grainTriggerCountdown[channel] = juce::jmax(1, baseInterval + randomVariation);
+                    const float densityFactor = juce::jmap(params.grainDensity, 0.1f, 4.0f, 0.1f, 4.0f);
+                    const int baseInterval = static_cast<int>(params.grainSizeSamples * 0.5f / densityFactor);
+                    const int randomVariation = static_cast<int>(baseInterval * params.randomization * (random.nextFloat() * 2.0f - 1.0f));
+                    grainTriggerCountdown[channel] = juce::jmax(1, baseInterval + randomVariation) + 1;
                 }
 
-                delayedSample = processActiveGrains(channel, delayBuffer);
+                runLength = juce::jmin(runLength, grainTriggerCountdown[channel] - 1);
             }
-            else
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                runLength = grainEngines[channel].getSafeRunLength(delayWriteIndex[channel], delayMask, runLength);
+
+            for (int channel = 0; channel < numChannels; ++channel)
             {
-                delayedSample = delayBuffer[delayWriteIndex[channel]];
+                grainEngines[channel].render(getDelayChannel<SampleType>(channel), delayMask,
+                                             wetBuffer.getWritePointer(channel, runStart), runLength);
+                grainTriggerCountdown[channel] -= runLength;
             }
+        }
 
-            // === EQ FILTERING ===
-            delayedSample = applyEQFiltering(delayedSample, channel, eqHigh, eqLow);
+        if (!useGrains)
+        {
+            // Without grains the delay is a plain tap delaySamples back, and a
+            // run stops short of reading anything it writes itself
+            const int readLag = juce::jmax(1, params.delaySamples - latency);
+            runLength = juce::jmin(runLength, readLag);
 
-            // === FEEDBACK PROCESSING ===
-            float feedbackSample = inputSample + (delayedSample * feedback);
-            feedbackSample = juce::jlimit(-1.0f, 1.0f, feedbackSample);
-            if (std::abs(feedbackSample) > 0.95f)
+            for (int channel = 0; channel < numChannels; ++channel)
             {
-                feedbackSample = feedbackSample > 0 ?
-                    0.95f + 0.05f * std::tanh((feedbackSample - 0.95f) * 10.0f) :
-                   -0.95f + 0.05f * std::tanh((feedbackSample + 0.95f) * 10.0f);
+                const auto* delayBuffer = getDelayChannel<SampleType>(channel);
+                const int readIndex = (delayWriteIndex[channel] - readLag) & delayMask;
+                auto* wet = wetBuffer.getWritePointer(channel, runStart);
+
+                const int first = juce::jmin(runLength, delayBufferSize - readIndex);
+                juce::FloatVectorOperations::copy(wet, delayBuffer + readIndex, first);
+                juce::FloatVectorOperations::copy(wet + first, delayBuffer, runLength - first);
             }
+        }
+
+        // === EQ FILTERING ===
+        // Nothing in the run feeds back into its own wet input, so the whole
+        // run can be filtered ahead of the feedback writes
+        state.feedbackEq.process(wetBuffer.getArrayOfWritePointers(), numChannels, runStart, runLength);
+
+        // === FEEDBACK PROCESSING ===
+        // input + delayed * feedback is saturated for all channels at once (the
+        // oversampler filters them together) and then copied into the ring in
+        // at most two wrap-free spans
+        auto* const* feedbackChannels = state.scratch.getArrayOfWritePointers(feedbackScratch);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* dest = feedbackChannels[channel] + runStart;
+            juce::FloatVectorOperations::copy(dest, buffer.getReadPointer(channel, runStart), runLength);
+            juce::FloatVectorOperations::addWithMultiply(dest, wetBuffer.getReadPointer(channel, runStart), static_cast<SampleType>(params.feedback), runLength);
+        }
+
+        state.feedbackSaturator.process(feedbackChannels, numChannels, runStart, runLength, params.saturation);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* saturated = feedbackChannels[channel] + runStart;
+            auto* delayBuffer = getDelayChannel<SampleType>(channel);
+            const int writeIndex = delayWriteIndex[channel];
+            const int first = juce::jmin(runLength, delayBufferSize - writeIndex);
 
-            delayBuffer[delayWriteIndex[channel]] = feedbackSample;
+            juce::FloatVectorOperations::copy(delayBuffer + writeIndex, saturated, first);
+            juce::FloatVectorOperations::copy(delayBuffer, saturated + first, runLength - first);
 
-            // === STEREO PROCESSING ===
-            if (buffer.getNumChannels() == 2 && stereoWidth > 0.0f)
+            delayWriteIndex[channel] = (writeIndex + runLength) & delayMask;
+        }
+
+        // Every ring's write head moves in step, so one update covers them all
+        delayPeaks.write(state.delayMemory.data(), numChannels, (delayWriteIndex[0] - runLength) & delayMask, runLength);
+
+        // === STEREO PROCESSING ===
+        // Each channel hears its partner's ring as it stands once this run is
+        // written, as the per-sample loop did, even when crossDelay is
+        // shorter than the block
+        if (params.stereoWidth > 0.0f)
+        {
+            const auto crossGain = static_cast<SampleType>(params.stereoWidth * 0.3f);
+
+            for (int channel = 0; channel < numChannels; ++channel)
             {
-                if (channel == 0)
-                {
-                    int crossDelay = static_cast<int>(delaySamples * 0.7f);
-                    crossDelay = (delayWriteIndex[channel] - crossDelay + maxDelayTime) % maxDelayTime;
-                    delayedSample += delayBuffers[1][crossDelay] * stereoWidth * 0.3f;
-                }
-                else
-                {
-                    int crossDelay = static_cast<int>(delaySamples * 0.8f);
-                    crossDelay = (delayWriteIndex[channel] - crossDelay + maxDelayTime) % maxDelayTime;
-                    delayedSample += delayBuffers[0][crossDelay] * stereoWidth * 0.3f;
-                }
-            }
+                const int otherChannel = crossFeedPartner[(size_t) channel];
+                if (otherChannel < 0 || otherChannel >= numChannels)
+                    continue;
 
-            // Mix dry and delay
-            channelData[sample] = inputSample * (1.0f - mix) + delayedSample * mix;
-            delayWriteIndex[channel] = (delayWriteIndex[channel] + 1) % maxDelayTime;
+                const int crossDelay = juce::jmax(0, static_cast<int>(params.delaySamples * crossFeedDelayFactor[(size_t) channel]) - latency);
+                const int readPos = (delayWriteIndex[channel] - runLength - crossDelay) & delayMask;
+                const int first = juce::jmin(runLength, delayBufferSize - readPos);
+
+                auto* wet = wetBuffer.getWritePointer(channel, runStart);
+                const auto* other = getDelayChannel<SampleType>(otherChannel);
+                juce::FloatVectorOperations::addWithMultiply(wet, other + readPos, crossGain, first);
+                juce::FloatVectorOperations::addWithMultiply(wet + first, other, crossGain, runLength - first);
+            }
         }
+
+        runStart += runLength;
     }
 
-    // === NEW ADVANCED PROCESSING ===
-    updateLFO();
-    
-    processFilter(buffer);
-    processPitchShift(buffer);
-    processChorus(buffer);
-    processFlanger(buffer);
-    processPanning(buffer);
-    
-    // Capture waveform data
-    captureWaveformData(buffer);
+    std::array<int, PeakPyramid::maxGrainMarkers> grainPositions;
+    int numGrainPositions = 0;
+    for (int channel = 0; channel < numChannels; ++channel)
+        numGrainPositions += grainEngines[channel].getReadPositions(grainPositions.data() + numGrainPositions,
+                                                                    PeakPyramid::maxGrainMarkers - numGrainPositions, delayMask);
+    delayPeaks.publishPositions(delayWriteIndex[0], grainPositions.data(), numGrainPositions);
+
+    // Mix dry and delay
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* channelData = buffer.getWritePointer(channel);
+        const auto mix = static_cast<SampleType>(params.mix);
+        juce::FloatVectorOperations::multiply(channelData, SampleType(1) - mix, blockLength);
+        juce::FloatVectorOperations::addWithMultiply(channelData, wetBuffer.getReadPointer(channel), mix, blockLength);
+    }
 }
 
-// === Advanced Processing Methods ===
 
-void MyPluginAudioProcessor::updateLFO()
+void MyPluginAudioProcessor::updateLFO(const ParamSnapshot& params, int numSamples)
 {
-    const float lfoRate = *valueTreeState.getRawParameterValue("lfoRate");
-    const bool tempoSync = *valueTreeState.getRawParameterValue("lfoTempoSync") > 0.5f;
-    
-    if (tempoSync)
+    if (params.lfoTempoSync)
     {
         auto playHead = getPlayHead();
         if (playHead != nullptr)
@@ -229,7 +769,7 @@ void MyPluginAudioProcessor::updateLFO()
                 auto bpm = position->getBpm();
                 if (bpm.hasValue())
                 {
-                    const float syncDivision = *valueTreeState.getRawParameterValue("lfoSyncDivision");
+                    const int syncDivision = params.lfoSyncDivision;
                     float beatsPerSecond = *bpm / 60.0f;
                     float divisor = syncDivision == 0 ? 4.0f : (syncDivision == 1 ? 2.0f : 1.0f);
                     lfoState.frequency = beatsPerSecond / divisor;
@@ -239,170 +779,150 @@ void MyPluginAudioProcessor::updateLFO()
     }
     else
     {
-        lfoState.frequency = juce::jmap(lfoRate, 0.0f, 100.0f, 0.1f, 10.0f);
+        lfoState.frequency = juce::jmap(params.lfoRate, 0.0f, 100.0f, 0.1f, 10.0f);
     }
     
-    // Update phase
-    lfoState.phase += lfoState.frequency * (1.0f / currentSampleRate) * currentBufferSize;
-    while (lfoState.phase >= 1.0f)
-        lfoState.phase -= 1.0f;
-}
+    // Render the block's modulation signal, one value per sample. Both
+    // waveforms are branch-free arithmetic on the phase, so the loops vectorise.
+    auto* lfo = floatScratch.getWritePointer(lfoScratch, 0);
+    const float increment = lfoState.frequency / static_cast<float>(currentSampleRate);
+    const float startPhase = lfoState.phase;
+    const float pi = juce::MathConstants<float>::pi;
 
-float MyPluginAudioProcessor::getLFOValue()
-{
-    const float waveform = *valueTreeState.getRawParameterValue("lfoWaveform");
-    const bool bipolar = *valueTreeState.getRawParameterValue("lfoBipolar") > 0.5f;
-    
-    float value = 0.0f;
-    
-    if (waveform < 0.5f) // Sine
+    for (int i = 0; i < numSamples; ++i)
     {
-        value = std::sin(lfoState.phase * 2.0f * juce::MathConstants<float>::pi);
+        const float phase = startPhase + increment * static_cast<float>(i);
+        lfo[i] = phase - std::floor(phase);
     }
-    else // Triangle
-    {
-        float trianglePhase = lfoState.phase * 4.0f;
-        if (trianglePhase < 1.0f)
-            value = trianglePhase;
-        else if (trianglePhase < 3.0f)
-            value = 2.0f - trianglePhase;
-        else
-            value = trianglePhase - 4.0f;
+
+    if (params.lfoWaveform == ParamSnapshot::lfoSine)
+    {
+        // sin(2 pi p) = -sin(2 pi p - pi), keeping the approximation inside [-pi, pi)
+        for (int i = 0; i < numSamples; ++i)
+            lfo[i] = -juce::dsp::FastMathApproximations::sin(2.0f * pi * lfo[i] - pi);
+    }
+    else
+    {
+        // Triangle: 0 at phase 0, +1 at 0.25, -1 at 0.75
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float shifted = lfo[i] + 0.25f;
+            lfo[i] = 1.0f - 4.0f * std::abs(shifted - std::floor(shifted) - 0.5f);
+        }
     }
-    
-    if (!bipolar)
-        value = (value + 1.0f) * 0.5f; // Convert to 0-1 range
-        
-    return value;
-}
 
-void MyPluginAudioProcessor::processFilter(juce::AudioBuffer<float>& buffer)
-{
-    const float cutoff = *valueTreeState.getRawParameterValue("filterCutoff");
-    const float resonance = *valueTreeState.getRawParameterValue("filterResonance");
-    const float filterType = *valueTreeState.getRawParameterValue("filterType");
-    const float lfoDepth = *valueTreeState.getRawParameterValue("lfoDepth");
-    const float lfoTarget = *valueTreeState.getRawParameterValue("lfoTarget");
-    
-    // Apply LFO modulation to cutoff if targeted
-    float modulatedCutoff = cutoff;
-    if (lfoTarget < 0.5f && lfoDepth > 0.0f) // Target is cutoff
+    if (!params.lfoBipolar)
     {
-        float lfoValue = getLFOValue();
-        modulatedCutoff = juce::jlimit(20.0f, 20000.0f, 
-            cutoff + (lfoValue * lfoDepth * 1000.0f));
+        // Convert to 0-1 range
+        juce::FloatVectorOperations::multiply(lfo, 0.5f, numSamples);
+        juce::FloatVectorOperations::add(lfo, 0.5f, numSamples);
     }
-    
-    // Set filter parameters
-    auto cutoffHz = juce::jmap(modulatedCutoff, 0.0f, 100.0f, 20.0f, 20000.0f);
-    auto q = juce::jmap(resonance, 0.0f, 100.0f, 0.5f, 10.0f);
-    
-    // Set filter type
-    const int mode = (int) std::round(*valueTreeState.getRawParameterValue("filterMode"));
 
-    switch (mode) // 0=LP, 1=BP, 2=HP mapping you already have
-{
-    case 0: stateVariableFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);  break;
-    case 1: stateVariableFilter.setType(juce::dsp::StateVariableTPTFilterType::bandpass); break;
-    case 2: stateVariableFilter.setType(juce::dsp::StateVariableTPTFilterType::highpass); break;
-    default: break;
-}
-    
-    stateVariableFilter.setCutoffFrequency(cutoffHz);
-    stateVariableFilter.setResonance(q);
-    
-    // Process
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    stateVariableFilter.process(context);
+    const float endPhase = startPhase + increment * static_cast<float>(numSamples);
+    lfoState.phase = endPhase - std::floor(endPhase);
 }
 
-void MyPluginAudioProcessor::processPitchShift(juce::AudioBuffer<float>& buffer)
+template <typename SampleType>
+void MyPluginAudioProcessor::processFilter(juce::AudioBuffer<SampleType>& buffer, const ParamSnapshot& params)
 {
-    const float semitones = *valueTreeState.getRawParameterValue("pitchSemitones");
-    const float octaves = *valueTreeState.getRawParameterValue("pitchOctaves");
+    auto& stateVariableFilter = getState<SampleType>().filter;
+    const float cutoff = params.filterCutoff;
+    const float lfoDepth = params.lfoDepth;
+    const bool isModulated = params.lfoTarget == ParamSnapshot::lfoToCutoff && lfoDepth > 0.0f;
     
-    float totalSemitones = semitones + (octaves * 12.0f);
+    auto toHz = ParamSnapshot::filterCutoffToHz;
+    auto q = ParamSnapshot::filterResonanceToQ(params.filterResonance);
     
-    if (std::abs(totalSemitones) < 0.1f) return; // No pitch shifting needed
+    // Set filter type
+    switch (params.filterMode)
+    {
+        case ParamSnapshot::lowpass:  stateVariableFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);  break;
+        case ParamSnapshot::bandpass: stateVariableFilter.setType(juce::dsp::StateVariableTPTFilterType::bandpass); break;
+        case ParamSnapshot::highpass: stateVariableFilter.setType(juce::dsp::StateVariableTPTFilterType::highpass); break;
+    }
     
-    float pitchRatio = std::pow(2.0f, totalSemitones / 12.0f);
+    stateVariableFilter.setResonance(static_cast<SampleType>(q));
     
-    // Update pitch smoothers
-    for (auto& smoother : pitchSmoother)
-        smoother.setTargetValue(pitchRatio);
+    juce::dsp::AudioBlock<SampleType> block(buffer);
     
-    // Simple granular pitch shifting
-    const int grainSize = 1024;
-    const int overlap = grainSize / 2;
+    if (!isModulated)
+    {
+        stateVariableFilter.setCutoffFrequency(static_cast<SampleType>(toHz(cutoff)));
+        juce::dsp::ProcessContextReplacing<SampleType> context(block);
+        stateVariableFilter.process(context);
+        return;
+    }
+    
+    // Apply LFO modulation to cutoff: one coefficient update per control-rate
+    // sub-block, so the sweep no longer steps at the host block size
+    const auto* lfo = floatScratch.getWritePointer(lfoScratch, 0);
+    const int numSamples = buffer.getNumSamples();
     
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    for (int start = 0; start < numSamples; start += modulationControlRate)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        auto* pitchBufferData = pitchBuffer[channel].data();
-        float currentPitchRatio = pitchSmoother[channel].getTargetValue();
+        const int length = juce::jmin(modulationControlRate, numSamples - start);
+        const float modulatedCutoff = juce::jlimit(0.0f, 100.0f, cutoff + lfo[start] * lfoDepth);
+        stateVariableFilter.setCutoffFrequency(static_cast<SampleType>(toHz(modulatedCutoff)));
         
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            // Write input to pitch buffer
-            pitchBufferData[pitchWriteIndex[channel]] = channelData[sample];
-            
-            // Read with pitch shift (simple time-domain approach)
-            if (pitchWriteIndex[channel] > grainSize)
-            {
-                float readPos = pitchWriteIndex[channel] - grainSize * (1.0f / currentPitchRatio);
-                int readIndex = static_cast<int>(readPos) % pitchBuffer[channel].size();
-                
-                if (readIndex >= 0 && readIndex < pitchBuffer[channel].size())
-                {
-                    // Simple linear interpolation
-                    float fraction = readPos - static_cast<int>(readPos);
-                    int nextIndex = (readIndex + 1) % pitchBuffer[channel].size();
-                    
-                    float interpolatedSample = pitchBufferData[readIndex] * (1.0f - fraction) + 
-                                             pitchBufferData[nextIndex] * fraction;
-                    
-                    // Apply window to reduce artifacts
-                    float window = 0.5f + 0.5f * std::cos(juce::MathConstants<float>::pi * 
-                                   (sample % grainSize) / float(grainSize));
-                    
-                    channelData[sample] = interpolatedSample * window * 0.5f + channelData[sample] * 0.5f;
-                }
-            }
-            
-            pitchWriteIndex[channel] = (pitchWriteIndex[channel] + 1) % pitchBuffer[channel].size();
-        }
+        auto subBlock = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(length));
+        juce::dsp::ProcessContextReplacing<SampleType> context(subBlock);
+        stateVariableFilter.process(context);
     }
 }
 
-void MyPluginAudioProcessor::processChorus(juce::AudioBuffer<float>& buffer)
+void MyPluginAudioProcessor::processPitchShift(juce::AudioBuffer<float>& buffer, const ParamSnapshot& params)
 {
-    const float chorusRate = *valueTreeState.getRawParameterValue("chorusRate");
-    const float chorusDepth = *valueTreeState.getRawParameterValue("chorusDepth");
-    const float chorusMix = *valueTreeState.getRawParameterValue("chorusMix") / 100.0f;
-    
-    if (chorusMix > 0.0f)
+    // Only called while the stage is active or fading out (see runFxStage)
+    const float totalSemitones = params.pitchSemitones + (params.pitchOctaves * 12.0f);
+    const float pitchRatio = std::pow(2.0f, totalSemitones / 12.0f);
+
+    // Whichever engine takes over starts from clean state
+    if (params.pitchMode != activePitchMode)
     {
-        chorus.setRate(juce::jmap(chorusRate, 0.0f, 100.0f, 0.1f, 5.0f));
-        chorus.setDepth(juce::jmap(chorusDepth, 0.0f, 100.0f, 0.0f, 1.0f));
-        chorus.setCentreDelay(5.0f); // 5ms center delay
-        chorus.setFeedback(0.3f);
-        chorus.setMix(chorusMix);
-        
-        juce::dsp::AudioBlock<float> block(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(block);
-        chorus.process(context);
+        pitchShifter.reset();
+        phaseVocoder.reset();
+        activePitchMode = params.pitchMode;
+    }
+
+    if (params.pitchMode == PhaseVocoder::spectral)
+    {
+        // Below the stage's threshold the vocoder just passes the delayed input
+        phaseVocoder.setConfiguration(params.pitchFftSize, params.pitchOverlap);
+        phaseVocoder.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(),
+                             std::abs(totalSemitones) >= 0.1f ? pitchRatio : 1.0f, params.pitchMix);
+        return;
     }
+
+    pitchShifter.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(),
+                         pitchRatio, params.pitchMix);
 }
 
-void MyPluginAudioProcessor::processFlanger(juce::AudioBuffer<float>& buffer)
+void MyPluginAudioProcessor::processChorus(juce::AudioBuffer<float>& buffer, const ParamSnapshot& params)
+{
+    const float chorusRate = params.chorusRate;
+    const float chorusDepth = params.chorusDepth;
+    const float chorusMix = params.chorusMix;
+    
+    // Still runs for the mix ramp's tail after chorusMix reaches zero (see runFxStage)
+    chorus.setRate(juce::jmap(chorusRate, 0.0f, 100.0f, 0.1f, 5.0f));
+    chorus.setDepth(juce::jmap(chorusDepth, 0.0f, 100.0f, 0.0f, 1.0f));
+    chorus.setCentreDelay(5.0f); // 5ms center delay
+    chorus.setFeedback(0.3f);
+    chorus.setMix(chorusMix);
+    
+    juce::dsp::AudioBlock<float> block(buffer);
+    juce::dsp::ProcessContextReplacing<float> context(block);
+    chorus.process(context);
+}
+
+void MyPluginAudioProcessor::processFlanger(juce::AudioBuffer<float>& buffer, const ParamSnapshot& params)
 {
     // Read UI parameters
-    const float flangerDelayParam    = *valueTreeState.getRawParameterValue("flangerDelay");     // 0..100
-    const float flangerDepthParam    = *valueTreeState.getRawParameterValue("flangerDepth");     // 0..100
-    const float flangerRateParam     = *valueTreeState.getRawParameterValue("flangerRate");      // 0..100
-    const float flangerMixParam      = *valueTreeState.getRawParameterValue("flangerMix") / 100.0f; // 0..1
-    const float flangerFeedbackParam = *valueTreeState.getRawParameterValue("flangerFeedback");  // 0..100
+    const float flangerDelayParam    = params.flangerDelay;    // 0..100
+    const float flangerDepthParam    = params.flangerDepth;    // 0..100
+    const float flangerRateParam     = params.flangerRate;     // 0..100
+    const float flangerMixParam      = params.flangerMix;      // 0..1
+    const float flangerFeedbackParam = params.flangerFeedback; // 0..100
 
     // Smooth feedback (single smoother, no per-channel array)
     flangerFeedbackSmoother.setTargetValue(flangerFeedbackParam / 100.0f);
@@ -424,138 +944,97 @@ void MyPluginAudioProcessor::processFlanger(juce::AudioBuffer<float>& buffer)
     flanger.process(ctx); // applies flanger in-place to the current buffer
 }
 
-void MyPluginAudioProcessor::processPanning(juce::AudioBuffer<float>& buffer)
+template <typename SampleType>
+void MyPluginAudioProcessor::processPanning(juce::AudioBuffer<SampleType>& buffer, const ParamSnapshot& params)
 {
     if (buffer.getNumChannels() < 2) return;
     
-    const float panValue = *valueTreeState.getRawParameterValue("panPosition");
-    const float lfoDepth = *valueTreeState.getRawParameterValue("lfoDepth");
-    const float lfoTarget = *valueTreeState.getRawParameterValue("lfoTarget");
-    
-    // Apply LFO modulation to pan if targeted
-    float modulatedPan = panValue;
-    if (lfoTarget > 0.5f && lfoDepth > 0.0f) // Target is pan
-    {
-        float lfoValue = getLFOValue();
-        modulatedPan = juce::jlimit(-100.0f, 100.0f, panValue + (lfoValue * lfoDepth));
-    }
-    
-    // Update pan smoothers
-    for (auto& smoother : panSmoother)
-        smoother.setTargetValue(modulatedPan / 100.0f); // Normalize to -1 to 1
+    // LFO modulation is added per sample on top of the smoothed pan position
+    const bool isModulated = params.lfoTarget == ParamSnapshot::lfoToPan && params.lfoDepth > 0.0f;
     
-    // Apply equal-power panning
-    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-    {
-        float panPos = panSmoother[0].getNextValue(); // Use same pan for both channels
-        
-        // Equal power panning
-        float panAngle = (panPos + 1.0f) * 0.25f * juce::MathConstants<float>::pi;
-        float leftGain = std::cos(panAngle);
-        float rightGain = std::sin(panAngle);
-        
-        float leftSample = buffer.getSample(0, sample);
-        float rightSample = buffer.getSample(1, sample);
-        
-        // Mix and apply gains
-        float mixedSample = (leftSample + rightSample) * 0.5f;
-        
-        buffer.setSample(0, sample, mixedSample * leftGain);
-        buffer.setSample(1, sample, mixedSample * rightGain);
-    }
-}
-
-void MyPluginAudioProcessor::captureWaveformData(const juce::AudioBuffer<float>& buffer)
-{
-    if (++waveformDownsampleCounter >= waveformDownsampleRate)
-    {
-        waveformDownsampleCounter = 0;
-        
-        // Calculate RMS for current buffer
-        float rms = 0.0f;
-        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-        {
-            float channelRms = buffer.getRMSLevel(channel, 0, buffer.getNumSamples());
-            rms += channelRms * channelRms;
-        }
-        rms = std::sqrt(rms / buffer.getNumChannels());
-        
-        // Store in circular buffer
-        int writeIdx = waveformData.writeIndex.load();
-        waveformData.buffer[writeIdx] = rms;
-        waveformData.writeIndex = (writeIdx + 1) % waveformData.buffer.size();
-        waveformData.hasNewData = true;
-    }
+    panStage.process(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples(),
+                     params.panPosition / 100.0f, params.panMode,
+                     isModulated ? floatScratch.getWritePointer(lfoScratch, 0) : nullptr,
+                     params.lfoDepth / 100.0f);
 }
 
 // === Original Helper Functions ===
 
-void MyPluginAudioProcessor::triggerNewGrain(int channel, int grainSize, float spray, bool reverse, float randomization)
+template <typename SampleType>
+void MyPluginAudioProcessor::scheduleSwarmGrains(int channel, const GranularParams& params, int runLength)
 {
-    for (int i = 0; i < maxGrains; ++i)
-    {
-        if (!activeGrains[channel][i].isActive)
-        {
-            auto& grain = activeGrains[channel][i];
+    // Onsets are tracked with a fractional countdown so intervals shorter than
+    // a sample still average out to the requested density. The interval never
+    // drops below what the grain pool can hold.
+    const float densityFactor = params.grainDensity * swarmDensityScale;
+    const float baseInterval = juce::jmax(params.grainSizeSamples * 0.5f / densityFactor,
+                                          static_cast<float>(params.grainSizeSamples) / swarmMaxGrains);
 
-            const float sprayAmount = spray * (random.nextFloat() * 2.0f - 1.0f);
-            const int sprayOffset = static_cast<int>(grainSize * sprayAmount);
+    auto& nextOnset = swarmNextOnset[channel];
 
-            grain.startPos = (delayWriteIndex[channel] - grainSize + sprayOffset + maxDelayTime) % maxDelayTime;
-            grain.size = juce::jlimit(32, 16384, grainSize);
-            grain.position = 0;
-            grain.isActive = true;
-            grain.isReverse = reverse;
-            grain.amplitude = 1.0f;
+    while (nextOnset < runLength)
+    {
+        triggerNewGrain<SampleType>(channel, params, static_cast<int>(nextOnset), swarmRunLength);
 
-            if (randomization > 0.0f)
-            {
-                const float sizeVariation = 1.0f + (random.nextFloat() * 2.0f - 1.0f) * randomization * 0.5f;
-                grain.size = juce::jlimit(32, 16384, static_cast<int>(grain.size * sizeVariation));
-                grain.amplitude *= (1.0f + (random.nextFloat() * 2.0f - 1.0f) * randomization * 0.3f);
-            }
-            break;
-        }
+        const float randomVariation = baseInterval * params.randomization * (random.nextFloat() * 2.0f - 1.0f);
+        nextOnset += juce::jmax(baseInterval * 0.1f, baseInterval + randomVariation);
     }
+
+    nextOnset -= runLength;
 }
 
-float MyPluginAudioProcessor::processActiveGrains(int channel, float* delayBuffer)
+template <typename SampleType>
+void MyPluginAudioProcessor::triggerNewGrain(int channel, const GranularParams& params, int onsetOffset, int minLag)
 {
-    float output = 0.0f;
+    auto& engine = getState<SampleType>().grainEngines[(size_t) channel];
+    if (!engine.hasFreeSlot())
+        return;
 
-    for (int i = 0; i < maxGrains; ++i)
-    {
-        auto& g = activeGrains[channel][i];
-        if (!g.isActive) continue;
-
-        const float progress = static_cast<float>(g.position) / juce::jmax(1, g.size);
-        const float envelope = 0.5f * (1.0f - std::cos(2.0f * juce::MathConstants<float>::pi * progress));
-
-        int readPos = g.isReverse
-            ? (g.startPos + g.size - g.position + maxDelayTime) % maxDelayTime
-            : (g.startPos + g.position) % maxDelayTime;
+    const int grainSize = params.grainSizeSamples;
+    const float sprayAmount = params.grainSpray * (random.nextFloat() * 2.0f - 1.0f);
+    const int sprayOffset = static_cast<int>(grainSize * sprayAmount);
 
-        output += delayBuffer[readPos] * envelope * g.amplitude;
+    int size = juce::jlimit(32, maxGrainSamples, grainSize);
+    float amplitude = params.grainGain;
 
-        if (++g.position >= g.size)
-            g.isActive = false;
+    if (params.randomization > 0.0f)
+    {
+        const float sizeVariation = 1.0f + (random.nextFloat() * 2.0f - 1.0f) * params.randomization * 0.5f;
+        size = juce::jlimit(32, maxGrainSamples, static_cast<int>(size * sizeVariation));
+        amplitude *= (1.0f + (random.nextFloat() * 2.0f - 1.0f) * params.randomization * 0.3f);
     }
 
-    return output;
-}
+    // Playback rate from the grain pitch, with up to a semitone of random
+    // detune at full randomization
+    float semitones = params.grainPitch;
+    if (params.grainDetune)
+        semitones += (random.nextFloat() * 2.0f - 1.0f) * params.randomization;
 
-float MyPluginAudioProcessor::applyEQFiltering(float sample, int channel, float highCut, float lowCut)
-{
-    const float highCutFreq = juce::jmap(highCut, 0.0f, 100.0f, 200.0f, 20000.0f);
-    const float lowCutFreq = juce::jmap(lowCut, 0.0f, 100.0f, 10.0f, 1000.0f);
+    const float rate = semitones == 0.0f ? 1.0f
+                                         : juce::jlimit(1.0f / maxGrainRate, maxGrainRate, std::exp2(semitones / 12.0f));
+
+    // How far behind the write head (at the onset) the grain starts reading,
+    // less the saturator latency the ring writes carry.
+    // A minimum lag keeps batched grains clear of samples written in this run.
+    // Grains played faster than the head moves start further back, by the
+    // extra ring they cover, so they never catch up with it.
+    const int extraSpan = rate > 1.0f ? static_cast<int>(std::ceil(size * (rate - 1.0f))) : 0;
+    int lag = juce::jmax(0, grainSize - sprayOffset - params.feedbackLatency) + extraSpan;
+    if (minLag > 0)
+        lag = juce::jmax(lag, (params.reverseGrains ? size + minLag : minLag) + extraSpan);
 
-    const float lpCoeff = std::exp(-2.0f * juce::MathConstants<float>::pi * (highCutFreq / (float)getSampleRate()));
-    highCutState[channel] = lpCoeff * highCutState[channel] + (1.0f - lpCoeff) * sample;
+    const int onsetIndex = delayWriteIndex[channel] + onsetOffset;
+    const int startPos = (onsetIndex - lag) & delayMask;
 
-    const float hpCoeff = std::exp(-2.0f * juce::MathConstants<float>::pi * (lowCutFreq / (float)getSampleRate()));
-    lowCutState[channel] = hpCoeff * lowCutState[channel] + (1.0f - hpCoeff) * highCutState[channel];
+    engine.startGrain(startPos, size, params.reverseGrains, amplitude, params.grainWindow, onsetOffset, rate);
 
-    return highCutState[channel] - lowCutState[channel];
+    GrainEvent event;
+    event.startLag = lag;
+    event.size = size;
+    event.amplitude = amplitude;
+    event.channel = static_cast<uint8_t>(channel);
+    event.isReverse = params.reverseGrains;
+    grainEvents.push(event); // dropped if the editor isn't draining the queue
 }
 
 void MyPluginAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
@@ -571,7 +1050,24 @@ void MyPluginAudioProcessor::setStateInformation(const void* data, int sizeInByt
     
     if (xmlState != nullptr)
         if (xmlState->hasTagName(valueTreeState.state.getType()))
-            valueTreeState.replaceState(juce::ValueTree::fromXml(*xmlState));
+        {
+            auto state = juce::ValueTree::fromXml(*xmlState);
+            
+            // Parameters the session predates keep their old behaviour
+            for (const auto& legacy : Params::legacyValues)
+            {
+                const auto* id = Params::table[(size_t) legacy.index].id;
+                if (!state.getChildWithProperty("id", id).isValid())
+                {
+                    juce::ValueTree param("PARAM");
+                    param.setProperty("id", id, nullptr);
+                    param.setProperty("value", legacy.value, nullptr);
+                    state.appendChild(param, nullptr);
+                }
+            }
+            
+            valueTreeState.replaceState(state);
+        }
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -581,90 +1077,27 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 
 juce::AudioProcessorValueTreeState::ParameterLayout MyPluginAudioProcessor::createParameterLayout()
 {
-    using P = juce::AudioParameterFloat;
-    using B = juce::AudioParameterBool;
-    using C = juce::AudioParameterChoice;
-
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
 
-    // === ORIGINAL PARAMETERS ===
-    params.push_back(std::make_unique<P>("delayTime", "Delay Time (ms)",
-        juce::NormalisableRange<float>(1.f, 2000.f, 0.01f, 0.35f), 400.f));
-    params.push_back(std::make_unique<P>("feedback", "Feedback",
-        juce::NormalisableRange<float>(0.f, 0.95f, 0.001f, 0.5f), 0.35f));
-    params.push_back(std::make_unique<P>("mix", "Mix (%)",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 35.f));
-
-    params.push_back(std::make_unique<P>("grainSize", "Grain Size (ms)",
-        juce::NormalisableRange<float>(5.f, 200.f, 0.01f, 0.5f), 60.f));
-    params.push_back(std::make_unique<P>("grainDensity", "Grain Density",
-        juce::NormalisableRange<float>(0.1f, 4.0f, 0.001f, 0.5f), 1.0f));
-    params.push_back(std::make_unique<P>("grainSpray", "Grain Spray (%)",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 10.f));
-    params.push_back(std::make_unique<B>("reverseGrains", "Reverse Grains", false));
-    params.push_back(std::make_unique<P>("randomization", "Randomization (%)",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 15.f));
-
-    params.push_back(std::make_unique<P>("stereoWidth", "Stereo Width (%)",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 50.f));
-    params.push_back(std::make_unique<P>("eqHigh", "High Cut",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 1.0f), 80.f));
-    params.push_back(std::make_unique<P>("eqLow", "Low Cut",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 1.0f), 10.f));
-
-    // === NEW ADVANCED PARAMETERS ===
-    
-    // Filter
-    params.push_back(std::make_unique<P>("filterCutoff", "Filter Cutoff",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.3f), 70.f));
-    params.push_back(std::make_unique<P>("filterResonance", "Filter Resonance",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 10.f));
-    params.push_back(std::make_unique<P>("filterType", "Filter Type",
-        juce::NormalisableRange<float>(0.f, 100.f, 1.f), 0.f)); // 0-33=LP, 34-66=BP, 67-100=HP
-    
-    // Pitch
-    params.push_back(std::make_unique<P>("pitchSemitones", "Pitch Semitones",
-        juce::NormalisableRange<float>(-12.f, 12.f, 0.01f), 0.f));
-    params.push_back(std::make_unique<P>("pitchOctaves", "Pitch Octaves",
-        juce::NormalisableRange<float>(-2.f, 2.f, 0.01f), 0.f));
-    
-    // Pan
-    params.push_back(std::make_unique<P>("panPosition", "Pan Position",
-        juce::NormalisableRange<float>(-100.f, 100.f, 0.01f), 0.f));
-    
-    // LFO
-    params.push_back(std::make_unique<P>("lfoRate", "LFO Rate",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 25.f));
-    params.push_back(std::make_unique<P>("lfoDepth", "LFO Depth",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 0.f));
-    params.push_back(std::make_unique<P>("lfoTarget", "LFO Target",
-        juce::NormalisableRange<float>(0.f, 100.f, 1.f), 0.f)); // 0-50=Cutoff, 51-100=Pan
-    params.push_back(std::make_unique<B>("lfoBipolar", "LFO Bipolar", true));
-    params.push_back(std::make_unique<P>("lfoWaveform", "LFO Waveform",
-        juce::NormalisableRange<float>(0.f, 100.f, 1.f), 0.f)); // 0-50=Sine, 51-100=Triangle
-    params.push_back(std::make_unique<B>("lfoTempoSync", "LFO Tempo Sync", false));
-    params.push_back(std::make_unique<P>("lfoSyncDivision", "LFO Sync Division",
-        juce::NormalisableRange<float>(0.f, 2.f, 1.f), 2.f)); // 0=1/4, 1=1/2, 2=1bar
-    
-    // Chorus
-    params.push_back(std::make_unique<P>("chorusRate", "Chorus Rate",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 50.f));
-    params.push_back(std::make_unique<P>("chorusDepth", "Chorus Depth",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 30.f));
-    params.push_back(std::make_unique<P>("chorusMix", "Chorus Mix",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 0.f));
-    
-    // Flanger
-    params.push_back(std::make_unique<P>("flangerDelay", "Flanger Delay",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 25.f));
-    params.push_back(std::make_unique<P>("flangerFeedback", "Flanger Feedback",
-        juce::NormalisableRange<float>(0.f, 95.f, 0.01f, 0.5f), 40.f));
-    params.push_back(std::make_unique<P>("flangerDepth", "Flanger Depth",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 60.f));
-    params.push_back(std::make_unique<P>("flangerRate", "Flanger Rate",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 30.f));
-    params.push_back(std::make_unique<P>("flangerMix", "Flanger Mix",
-        juce::NormalisableRange<float>(0.f, 100.f, 0.01f, 0.5f), 0.f));
+    for (const auto& spec : Params::table)
+    {
+        switch (spec.kind)
+        {
+            case Params::Kind::floating:
+                params.push_back(std::make_unique<juce::AudioParameterFloat>(spec.id, spec.name,
+                    juce::NormalisableRange<float>(spec.minValue, spec.maxValue, spec.interval, spec.skew), spec.defaultValue));
+                break;
+
+            case Params::Kind::boolean:
+                params.push_back(std::make_unique<juce::AudioParameterBool>(spec.id, spec.name, spec.defaultValue > 0.5f));
+                break;
+
+            case Params::Kind::choice:
+                params.push_back(std::make_unique<juce::AudioParameterChoice>(spec.id, spec.name,
+                    spec.choices(), static_cast<int>(spec.defaultValue)));
+                break;
+        }
+    }
 
     return {params.begin(), params.end()};
-}
\ No newline at end of file
+}
@@ -3,20 +3,35 @@
 #include <array>
 #include <vector>
 #include <cmath>
+#include <type_traits>
+#include "GrainEngine.h"
+#include "ScratchArena.h"
+#include "Parameters.h"
+#include "StageBypass.h"
+#include "SilenceDetector.h"
+#include "PitchShifter.h"
+#include "ScopeFifo.h"
+#include "PeakPyramid.h"
+#include "SpectrumAnalyser.h"
+#include "GrainEvents.h"
 
 class MyPluginAudioProcessorEditor;
 
-class MyPluginAudioProcessor : public juce::AudioProcessor
+class MyPluginAudioProcessor : public juce::AudioProcessor,
+                               private juce::AudioProcessorValueTreeState::Listener,
+                               private juce::AsyncUpdater
 {
 public:
     MyPluginAudioProcessor();
-    ~MyPluginAudioProcessor() override = default;
+    ~MyPluginAudioProcessor() override;
 
     // === JUCE overrides ===
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -24,7 +39,7 @@ public:
     const juce::String getName() const override { return "MyPlugin"; }
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.0; }
+    double getTailLengthSeconds() const override;
 
     int getNumPrograms() override { return 1; }
     int getCurrentProgram() override { return 0; }
@@ -41,48 +56,158 @@ public:
     // Expose parameters so the Editor can attach sliders
     juce::AudioProcessorValueTreeState valueTreeState;
     
-    // Waveform data for visualization
-    struct WaveformData
-    {
-        std::array<float, 512> buffer{};
-        std::atomic<int> writeIndex{0};
-        std::atomic<bool> hasNewData{false};
-    };
-    WaveformData waveformData;
+    // Input/output level frames for the scope, one per processed block.
+    // Written by the audio thread only, read by the editor only.
+    ScopeFifo scopeFifo;
+
+    // Min / max overview of the delay rings plus the write head and grain read
+    // positions, for the delay memory display. Same threading as scopeFifo.
+    PeakPyramid delayPeaks;
+
+    // Mono mix of the input and output for the spectrum analyser; idle unless
+    // an analyser is listening
+    SpectrumTap inputSpectrum, outputSpectrum;
+
+    // Every grain onset on any channel, for the grain cloud. Same threading as
+    // scopeFifo.
+    GrainEventQueue grainEvents;
 
 private:
     // ===== Delay & Granular State =====
-    static constexpr int maxDelayTime = 192000; // ~4s @ 48kHz
-    std::array<std::vector<float>, 2> delayBuffers; // [channel][sample]
-    std::array<int, 2> delayWriteIndex { 0, 0 };
+    // Rings hold the longest delay time plus room for the furthest grain read
+    // behind the write head, rounded up to a power of two so every index wraps
+    // with delayMask. Sized from the sample rate in prepareToPlay.
+    static constexpr float maxDelayMs = 2000.0f;
+    static constexpr int maxGrainSamples = 16384;
+    static constexpr float maxGrainRate = 4.0f; // grain playback rates stay within 1/4 .. 4
+    int delayBufferSize = 0;
+    int delayMask = 0;
+
+    // Widest layout accepted. The audio thread wraps channel lists in
+    // non-owning AudioBuffers, which only keep up to 32 pointers inline and
+    // would allocate beyond that.
+    static constexpr int maxChannels = 32;
+    int numDelayChannels = 0;
+    std::vector<int> delayWriteIndex;
+
+    // Stereo-width cross-feed: the channel each channel borrows delayed signal
+    // from (-1 for none) and how far back, as a fraction of the delay time.
+    // Built from the output layout in prepareToPlay.
+    std::vector<int> crossFeedPartner;
+    std::vector<float> crossFeedDelayFactor;
+    void buildCrossFeedPolicy (int numChannels);
+
+    GrainWindowTable grainWindowTable;
+    std::vector<int> grainTriggerCountdown;
+
+    // Swarm (high-density) mode: grains per channel, density multiplier and
+    // the fixed run length onsets are batched over
+    static constexpr int swarmMaxGrains = 1024;
+    static constexpr float swarmDensityScale = 128.0f;
+    static constexpr int swarmRunLength = 32;
+    std::vector<float> swarmNextOnset;
 
-    struct Grain
+    // Per-block scratch, carved from arenas sized in prepareToPlay. Host
+    // blocks longer than the prepared size are processed in slices.
+    // Audio runs in the processing precision (see SampleState)...
+    enum AudioScratch
     {
-        int   startPos   = 0;
-        int   size       = 0;
-        int   position   = 0;
-        bool  isActive   = false;
-        bool  isReverse  = false;
-        float amplitude  = 1.0f;
+        granularWetScratch,   // granular output before EQ/feedback/mix, one channel per output
+        grainEnvelopeScratch, // grain window run, shared by the grain engines
+        grainGatherScratch,   // reversed or resampled ring read, shared by the grain engines
+        stageDryScratch,      // dry copy for an effect stage that is crossfading in or out
+        feedbackScratch,      // input + feedback for the current run, before saturation
+        numAudioScratch
     };
 
-    static constexpr int maxGrains = 32;
-    std::array<std::array<Grain, maxGrains>, 2> activeGrains {};
-    std::array<int, 2> grainTriggerCountdown { 0, 0 };
+    // ...while control signals and the float-only stages always use float
+    enum FloatScratch
+    {
+        lfoScratch,           // per-sample LFO output for the block
+        panScratch,           // per-sample pan positions while the pan ramps
+        pitchTapScratch,      // pitch shifter tap delays and gains, shared by all channels
+        floatStageScratch,    // float copy of a double block for pitch, chorus and flanger
+        numFloatScratch
+    };
+    ScratchArena<float> floatScratch;
+
+    struct GranularParams
+    {
+        float feedback = 0.0f;
+        float mix = 0.0f;
+        float grainDensity = 1.0f;
+        float grainSpray = 0.0f;
+        float stereoWidth = 0.0f;
+        float eqHigh = 0.0f;
+        float eqLow = 0.0f;
+        int eqSlope = 0;
+        int saturation = 0;
+        float randomization = 0.0f;
+        bool reverseGrains = false;
+        bool swarmMode = false;
+        float grainGain = 1.0f;
+        int grainWindow = 0;
+        float grainPitch = 0.0f; // semitones
+        bool grainDetune = false;
+        int delaySamples = 1;
+        int grainSizeSamples = 64;
+        int feedbackLatency = 0; // samples the saturator delays each ring write
+    };
+
+    // ===== Sample-Precision State =====
+    // Everything that stores or recirculates audio, in the precision the host
+    // processes in. Only the instance matching isUsingDoublePrecision() is
+    // prepared; the other is released.
+    template <typename SampleType>
+    struct SampleState
+    {
+        std::vector<SampleType> delayMemory; // one ring per output channel, back to back
+        std::vector<GrainEngine<SampleType>> grainEngines;
+
+        // High/low cut on the delayed signal, ahead of the feedback write
+        FeedbackEq<SampleType> feedbackEq;
 
-    // Simple one-pole filter state per channel
-    std::array<float, 2> highCutState { 0.0f, 0.0f };
-    std::array<float, 2> lowCutState  { 0.0f, 0.0f };
+        // Saturation of the feedback write, oversampled on request. The loop
+        // reads the ring its latency closer to the write head to make up for it.
+        FeedbackSaturator<SampleType> feedbackSaturator;
+
+        juce::dsp::StateVariableTPTFilter<SampleType> filter;
+
+        ScratchArena<SampleType> scratch; // AudioScratch buffers
+
+        void release()
+        {
+            delayMemory = {};
+            grainEngines = std::vector<GrainEngine<SampleType>>();
+            scratch.prepare ({}, 0);
+        }
+    };
+
+    SampleState<float> floatState;
+    SampleState<double> doubleState;
+
+    template <typename SampleType>
+    SampleState<SampleType>& getState() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleState;
+        else
+            return floatState;
+    }
+
+    template <typename SampleType>
+    SampleType* getDelayChannel (int channel) noexcept
+    {
+        return getState<SampleType>().delayMemory.data() + (size_t) channel * (size_t) delayBufferSize;
+    }
 
     // ===== Advanced DSP Components =====
     
-    // Filter
-    juce::dsp::StateVariableTPTFilter<float> stateVariableFilter;
-    
-    // Pitch Shifting (using simple granular approach)
-    std::array<std::vector<float>, 2> pitchBuffer;
-    std::array<int, 2> pitchWriteIndex{0, 0};
-    std::array<juce::SmoothedValue<float>, 2> pitchSmoother;
+
+    // Pitch Shifting: dual-tap delay line, or STFT phase vocoder for polyphonic material
+    PitchShifter pitchShifter;
+    PhaseVocoder phaseVocoder;
+    int activePitchMode = PhaseVocoder::timeDomain;
 
     juce::SmoothedValue<float> flangerFeedbackSmoother;
     
@@ -104,32 +229,66 @@ private:
         int syncDivision = 2; // 0=1/4, 1=1/2, 2=1bar
     };
     LFOState lfoState;
+
+    // Filter cutoff follows the LFO at this control rate (samples per coefficient update)
+    static constexpr int modulationControlRate = 16;
     
     // Pan
-    std::array<juce::SmoothedValue<float>, 2> panSmoother;
+    PanStage panStage;
     
-    // Waveform capture
-    int waveformDownsampleCounter = 0;
-    static constexpr int waveformDownsampleRate = 64; // Capture every 64th sample
+    // Advanced FX stages that are skipped while they have no audible effect
+    enum FxStage { fxFilter = 0, fxPitch, fxChorus, fxFlanger, fxPan, numFxStages };
+    std::array<StageBypass, numFxStages> stageBypass;
+
+    // Sleeps the whole chain once input and delay memory have gone silent
+    SilenceDetector silenceDetector;
+
+
+    // Raw value of every Params::table entry, resolved once in the constructor
+    std::array<std::atomic<float>*, Params::numParams> rawParams {};
 
     juce::Random random;
     double currentSampleRate = 44100.0;
     int currentBufferSize = 512;
 
-    // Helpers used by processBlock
-    void  triggerNewGrain (int channel, int grainSize, float spray, bool reverse, float randomization);
-    float processActiveGrains (int channel, float* delayBuffer);
-    float applyEQFiltering   (float sample, int channel, float highCut, float lowCut);
+    // Helpers used by processBlock, instantiated for float and double
+    ParamSnapshot readParamSnapshot() const;
+    template <typename SampleType>
+    void  prepareSampleState (double sampleRate, int samplesPerBlock, int numChannels);
+    template <typename SampleType>
+    void  processBlockInternal (juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType>
+    void  processChain (juce::AudioBuffer<SampleType>& buffer, const ParamSnapshot& params);
+    template <typename SampleType>
+    void  processGranularDelay (juce::AudioBuffer<SampleType>& buffer, const GranularParams& params);
+    template <typename SampleType>
+    void  scheduleSwarmGrains (int channel, const GranularParams& params, int runLength);
+    template <typename SampleType>
+    void  triggerNewGrain (int channel, const GranularParams& params, int onsetOffset = 0, int minLag = 0);
     
     // New advanced processing helpers
-    void processFilter(juce::AudioBuffer<float>& buffer);
-    void processPitchShift(juce::AudioBuffer<float>& buffer);
-    void processChorus(juce::AudioBuffer<float>& buffer);
-    void processFlanger(juce::AudioBuffer<float>& buffer);
-    void processPanning(juce::AudioBuffer<float>& buffer);
-    void updateLFO();
-    float getLFOValue();
-    void captureWaveformData(const juce::AudioBuffer<float>& buffer);
+    template <typename SampleType>
+    void processFilter(juce::AudioBuffer<SampleType>& buffer, const ParamSnapshot& params);
+    void processPitchShift(juce::AudioBuffer<float>& buffer, const ParamSnapshot& params);
+    void processChorus(juce::AudioBuffer<float>& buffer, const ParamSnapshot& params);
+    void processFlanger(juce::AudioBuffer<float>& buffer, const ParamSnapshot& params);
+    template <typename SampleType>
+    void processPanning(juce::AudioBuffer<SampleType>& buffer, const ParamSnapshot& params);
+    template <typename SampleType, typename ProcessFn, typename ResetFn>
+    void runFxStage(FxStage stage, juce::AudioBuffer<SampleType>& buffer, bool isActive, int tailSamples,
+                    ProcessFn&& process, ResetFn&& reset);
+    template <typename ProcessFn>
+    void processInFloat(juce::AudioBuffer<float>& buffer, ProcessFn&& process);
+    template <typename ProcessFn>
+    void processInFloat(juce::AudioBuffer<double>& buffer, ProcessFn&& process);
+    void updateLFO(const ParamSnapshot& params, int numSamples);
+
+    // Latency is reported from the message thread whenever a parameter that
+    // changes it moves
+    static constexpr Params::ID latencyParams[] = { Params::pitchMode, Params::pitchFftSize, Params::pitchOverlap };
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    void updateLatency();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MyPluginAudioProcessor)
 };
\ No newline at end of file
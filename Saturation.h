@@ -0,0 +1,92 @@
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+// Soft-clip kernels for the delay feedback path.
+//
+// Every curve is straight-line arithmetic with min/max clamps (no branches,
+// no libm calls), so process() costs the same for any signal level and the
+// per-curve loops auto-vectorise. Templated on the sample type so the double
+// precision path saturates without a round trip through float.
+//==============================================================================
+namespace Saturation
+{
+    enum Character { knee = 0, tanhRational, cubic, tube, numCharacters };
+
+    inline juce::StringArray getCharacterNames() { return { "Knee", "Tanh", "Cubic", "Tube" }; }
+
+    // Pade tanh, within 1e-6 of std::tanh inside [-3, 3] and 1e-4 at the +-5 clamp
+    template <typename SampleType>
+    inline SampleType fastTanh (SampleType x) noexcept
+    {
+        using T = SampleType;
+        x = std::min (T (5), std::max (T (-5), x));
+        const T x2 = x * x;
+        const T y = x * (T (135135) + x2 * (T (17325) + x2 * (T (378) + x2)))
+                      / (T (135135) + x2 * (T (62370) + x2 * (T (3150) + x2 * T (28))));
+        return std::min (T (1), std::max (T (-1), y));
+    }
+
+    // Hard limit at +-1 with a tanh knee above 0.95 (the original feedback limiter)
+    template <typename SampleType>
+    inline SampleType kneeSample (SampleType x) noexcept
+    {
+        using T = SampleType;
+        const T a = std::min (std::abs (x), T (1));
+        const T over = std::max (a - T (0.95), T (0));
+        return std::copysign (std::min (a, T (0.95)) + T (0.05) * fastTanh (over * T (10)), x);
+    }
+
+    template <typename SampleType>
+    inline SampleType tanhSample (SampleType x) noexcept { return fastTanh (x); }
+
+    // Classic 1.5x - 0.5x^3, flat at +-1
+    template <typename SampleType>
+    inline SampleType cubicSample (SampleType x) noexcept
+    {
+        using T = SampleType;
+        x = std::min (T (1), std::max (T (-1), x));
+        return x * (T (1.5) - T (0.5) * x * x);
+    }
+
+    // Biased tanh: unity small-signal gain, softer on the positive swing than
+    // the negative one, so it adds even harmonics. The negative swing would
+    // run on to -1.32, so it bends through a second tanh rather than a clamp;
+    // that keeps the slope and curvature through zero and levels off near
+    // -0.87 against +0.80 on top. The low cut in the loop removes the DC this
+    // generates.
+    template <typename SampleType>
+    inline SampleType tubeSample (SampleType x) noexcept
+    {
+        using T = SampleType;
+        const T bias = T (0.25);
+        const T t = fastTanh (bias);
+        const T y = (fastTanh (x + bias) - t) / (T (1) - t * t);
+        return std::max (y, T (0)) + fastTanh (std::min (y, T (0)));
+    }
+
+    template <typename SampleType, typename Curve>
+    inline void applyCurve (SampleType* data, int numSamples, Curve curve) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = curve (data[i]);
+    }
+
+    // Saturates data in place with the selected character
+    template <typename SampleType>
+    inline void process (SampleType* data, int numSamples, int character) noexcept
+    {
+        using T = SampleType;
+
+        switch (character)
+        {
+            case tanhRational: applyCurve (data, numSamples, [] (T x) { return tanhSample (x); });  break;
+            case cubic:        applyCurve (data, numSamples, [] (T x) { return cubicSample (x); }); break;
+            case tube:         applyCurve (data, numSamples, [] (T x) { return tubeSample (x); });  break;
+            case knee:
+            default:           applyCurve (data, numSamples, [] (T x) { return kneeSample (x); });  break;
+        }
+    }
+}
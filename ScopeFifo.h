@@ -0,0 +1,46 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+#include "SpscQueue.h"
+
+//==============================================================================
+// One scope frame: the level of one processed block, before and after the
+// plugin, reduced to min / max / RMS across all channels.
+//==============================================================================
+struct ScopeFrame
+{
+    struct Level
+    {
+        float min = 0.0f, max = 0.0f, rms = 0.0f;
+
+        template <typename SampleType>
+        static Level measure (const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept
+        {
+            Level level;
+            const int numSamples = buffer.getNumSamples();
+            if (numChannels <= 0 || numSamples <= 0)
+                return level;
+
+            level.min = level.max = static_cast<float> (buffer.getSample (0, 0));
+            double sumOfSquares = 0.0;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const auto range = juce::FloatVectorOperations::findMinAndMax (buffer.getReadPointer (channel), numSamples);
+                level.min = juce::jmin (level.min, static_cast<float> (range.getStart()));
+                level.max = juce::jmax (level.max, static_cast<float> (range.getEnd()));
+
+                const auto rms = static_cast<double> (buffer.getRMSLevel (channel, 0, numSamples));
+                sumOfSquares += rms * rms;
+            }
+
+            level.rms = static_cast<float> (std::sqrt (sumOfSquares / numChannels));
+            return level;
+        }
+    };
+
+    Level input, output;
+};
+
+// One frame per processed block; the editor drains them on its frame tick
+using ScopeFifo = SpscQueue<ScopeFrame, 1024>;
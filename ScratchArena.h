@@ -0,0 +1,79 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+// One preallocated block of sample scratch memory, carved into fixed
+// multi-channel buffers of maxBlockSize samples each.
+//
+// Everything is sized in prepare() (call from prepareToPlay); the accessors
+// only hand out pointers into that memory, so the audio thread never touches
+// the allocator.
+//==============================================================================
+template <typename SampleType>
+class ScratchArena
+{
+public:
+    // channelsPerBuffer[i] = number of channels in buffer i
+    void prepare (const std::vector<int>& channelsPerBuffer, int maxBlockSizeToUse)
+    {
+        maxBlockSize = juce::jmax (0, maxBlockSizeToUse);
+
+        // Round each channel up to a whole cache line so every channel starts aligned
+        constexpr int samplesPerLine = alignment / (int) sizeof (SampleType);
+        channelStride = (maxBlockSize + samplesPerLine - 1) / samplesPerLine * samplesPerLine;
+
+        firstChannel.clear();
+        numChannels.clear();
+        int totalChannels = 0;
+
+        for (auto channels : channelsPerBuffer)
+        {
+            firstChannel.push_back (totalChannels);
+            numChannels.push_back (channels);
+            totalChannels += channels;
+        }
+
+        memory.calloc ((size_t) (totalChannels * channelStride + samplesPerLine));
+
+        auto* base = memory.get();
+        while (reinterpret_cast<uintptr_t> (base) % alignment != 0)
+            ++base;
+
+        channelPointers.resize ((size_t) totalChannels);
+        for (int i = 0; i < totalChannels; ++i)
+            channelPointers[(size_t) i] = base + i * channelStride;
+    }
+
+    int getMaxBlockSize() const noexcept                 { return maxBlockSize; }
+    int getNumChannels (int buffer) const noexcept       { return numChannels[(size_t) buffer]; }
+
+    SampleType* getWritePointer (int buffer, int channel) const noexcept
+    {
+        jassert (channel < getNumChannels (buffer));
+        return channelPointers[(size_t) (firstChannel[(size_t) buffer] + channel)];
+    }
+
+    SampleType* const* getArrayOfWritePointers (int buffer) const noexcept
+    {
+        return channelPointers.data() + firstChannel[(size_t) buffer];
+    }
+
+    // Non-owning AudioBuffer view of the first numSamples of a buffer. JUCE keeps
+    // the channel pointer list for up to 32 channels inline, so this doesn't
+    // allocate as long as the processor's layouts stay within that.
+    juce::AudioBuffer<SampleType> getBuffer (int buffer, int numSamples) const noexcept
+    {
+        jassert (numSamples <= maxBlockSize);
+        return { getArrayOfWritePointers (buffer), getNumChannels (buffer), numSamples };
+    }
+
+private:
+    static constexpr int alignment = 64;
+
+    juce::HeapBlock<SampleType> memory;
+    std::vector<SampleType*> channelPointers;
+    std::vector<int> firstChannel, numChannels;
+    int maxBlockSize = 0;
+    int channelStride = 0;
+};
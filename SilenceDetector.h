@@ -0,0 +1,87 @@
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+// Decides when the plugin can sleep.
+//
+// The owner reports once per block whether the input, the delay output and
+// the plugin output all stayed below the threshold. After enough consecutive
+// quiet samples to have flushed the whole delay memory, the detector goes to
+// sleep; while asleep the owner only scans the input for the first audible
+// sample and wakes exactly there.
+//==============================================================================
+class SilenceDetector
+{
+public:
+    static constexpr float threshold = 1.0e-5f; // about -100 dBFS
+
+    // quietSamplesToSleep = how long everything must stay quiet before sleeping
+    void prepare (int quietSamplesToSleep)
+    {
+        samplesToSleep = quietSamplesToSleep;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        quietSamples = 0;
+        sleeping = false;
+    }
+
+    void update (bool blockIsQuiet, int numSamples) noexcept
+    {
+        quietSamples = blockIsQuiet ? quietSamples + numSamples : 0;
+        sleeping = quietSamples >= samplesToSleep;
+    }
+
+    void wake() noexcept { reset(); }
+    bool isSleeping() const noexcept { return sleeping; }
+
+    template <typename SampleType>
+    static bool isQuiet (const SampleType* data, int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return true;
+
+        const auto range = juce::FloatVectorOperations::findMinAndMax (data, numSamples);
+        return range.getStart() > -SampleType (threshold) && range.getEnd() < SampleType (threshold);
+    }
+
+    template <typename SampleType>
+    static bool isQuiet (const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            if (! isQuiet (buffer.getReadPointer (channel), buffer.getNumSamples()))
+                return false;
+        return true;
+    }
+
+    // Index of the first sample on any channel at or above the threshold, or -1
+    template <typename SampleType>
+    static int findFirstAudible (const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept
+    {
+        int first = -1;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* data = buffer.getReadPointer (channel);
+            const int end = first < 0 ? buffer.getNumSamples() : first;
+
+            for (int i = 0; i < end; ++i)
+            {
+                if (std::abs (data[i]) >= SampleType (threshold))
+                {
+                    first = i;
+                    break;
+                }
+            }
+        }
+
+        return first;
+    }
+
+private:
+    int samplesToSleep = 0;
+    int quietSamples = 0;
+    bool sleeping = false;
+};
@@ -0,0 +1,175 @@
+#include "SpectrumAnalyser.h"
+
+SpectrumAnalyser::SpectrumAnalyser(SpectrumTap& inputTap, SpectrumTap& outputTap)
+    : juce::Thread("Spectrum Analyser")
+{
+    channels[0].tap = &inputTap;
+    channels[1].tap = &outputTap;
+
+    for (auto& channel : channels)
+        channel.tap->setListening(true);
+
+    startThread();
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    for (auto& channel : channels)
+        channel.tap->setListening(false);
+
+    stopThread(1000);
+}
+
+void SpectrumAnalyser::setActive(bool shouldBeActive) noexcept
+{
+    active.store(shouldBeActive);
+    for (auto& channel : channels)
+        channel.tap->setListening(shouldBeActive);
+
+    notify();
+}
+
+void SpectrumAnalyser::setPeakHold(bool shouldHold) noexcept
+{
+    if (shouldHold && !peakHold.load())
+        peakResetPending.store(true);
+
+    peakHold.store(shouldHold);
+}
+
+bool SpectrumAnalyser::getLatest(Spectrum& dest)
+{
+    const juce::ScopedLock lock(publishLock);
+    if (!hasNewSpectrum)
+        return false;
+
+    dest = published;
+    hasNewSpectrum = false;
+    return true;
+}
+
+void SpectrumAnalyser::run()
+{
+    // Whatever a previous analyser left queued is stale
+    for (auto& channel : channels)
+        channel.tap->pop(nullptr, SpectrumTap::capacity);
+
+    while (!threadShouldExit())
+    {
+        if (!active.load())
+        {
+            // Drop what was queued before the pause; it would only show stale audio
+            for (auto& channel : channels)
+                channel.tap->pop(nullptr, SpectrumTap::capacity);
+
+            wait(100);
+            continue;
+        }
+
+        const int sizeIndex = requestedFftSize.load();
+        if (sizeIndex != currentSizeIndex)
+            configure(sizeIndex);
+
+        if (peakResetPending.exchange(false))
+            for (auto& channel : channels)
+                channel.peak = channel.level;
+
+        bool hasNewFrame = false;
+        for (auto& channel : channels)
+            hasNewFrame = analyse(channel) || hasNewFrame;
+
+        if (hasNewFrame)
+            publish();
+        else
+            wait(10);
+    }
+}
+
+void SpectrumAnalyser::configure(int sizeIndex)
+{
+    currentSizeIndex = juce::jlimit(0, numFftSizes - 1, sizeIndex);
+    fftSize = 1 << (minOrder + currentSizeIndex);
+    fft = std::make_unique<juce::dsp::FFT>(minOrder + currentSizeIndex);
+
+    window.resize((size_t) fftSize);
+    for (int n = 0; n < fftSize; ++n)
+        window[(size_t) n] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * static_cast<float>(n) / static_cast<float>(fftSize));
+
+    // The frequency-only transform works in place on twice the frame size
+    fftData.assign((size_t) (2 * fftSize), 0.0f);
+
+    for (auto& channel : channels)
+    {
+        channel.history.assign((size_t) fftSize, 0.0f);
+        channel.historyWrite = 0;
+        channel.samplesUntilFrame = fftSize;
+        channel.level.assign((size_t) (fftSize / 2 + 1), minDecibels);
+        channel.peak = channel.level;
+    }
+}
+
+bool SpectrumAnalyser::analyse(Channel& channel)
+{
+    auto& tap = *channel.tap;
+
+    // If the worker fell behind, skip ahead rather than drawing old audio
+    const int backlog = tap.getNumReady() - 2 * fftSize;
+    if (backlog > 0)
+        tap.pop(nullptr, backlog + fftSize);
+
+    bool ranFrame = false;
+
+    while (tap.getNumReady() > 0)
+    {
+        const int count = juce::jmin(channel.samplesUntilFrame, fftSize - channel.historyWrite);
+        const int popped = tap.pop(channel.history.data() + channel.historyWrite, count);
+        if (popped == 0)
+            break;
+
+        channel.historyWrite = (channel.historyWrite + popped) & (fftSize - 1);
+        channel.samplesUntilFrame -= popped;
+        if (channel.samplesUntilFrame > 0)
+            continue;
+
+        // Hop of half a frame: 50% overlap, which sums flat for Hann
+        channel.samplesUntilFrame = fftSize / 2;
+        ranFrame = true;
+
+        // Unroll the history oldest first under the window
+        const int tail = fftSize - channel.historyWrite;
+        std::copy_n(channel.history.begin() + channel.historyWrite, tail, fftData.begin());
+        std::copy_n(channel.history.begin(), channel.historyWrite, fftData.begin() + tail);
+        juce::FloatVectorOperations::multiply(fftData.data(), window.data(), fftSize);
+        std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+        fft->performFrequencyOnlyForwardTransform(fftData.data());
+
+        // A full-scale sine reads 0 dB: the Hann window sums to fftSize / 2 and
+        // the tone's energy is split between the positive and negative bins
+        const float toAmplitude = 4.0f / static_cast<float>(fftSize);
+        const float smoothing = averaging.load();
+        const bool holdPeaks = peakHold.load();
+
+        for (size_t bin = 0; bin < channel.level.size(); ++bin)
+        {
+            const float decibels = juce::Decibels::gainToDecibels(fftData[bin] * toAmplitude, minDecibels);
+            auto& level = channel.level[bin];
+            level = smoothing * level + (1.0f - smoothing) * decibels;
+            channel.peak[bin] = holdPeaks ? juce::jmax(channel.peak[bin], level) : level;
+        }
+    }
+
+    return ranFrame;
+}
+
+void SpectrumAnalyser::publish()
+{
+    const juce::ScopedLock lock(publishLock);
+
+    published.fftSize = fftSize;
+    published.input = channels[0].level;
+    published.output = channels[1].level;
+    published.inputPeak = channels[0].peak;
+    published.outputPeak = channels[1].peak;
+    hasNewSpectrum = true;
+}
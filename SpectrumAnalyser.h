@@ -0,0 +1,149 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+// Wait-free single-producer / single-consumer queue of mono samples from the
+// audio thread to the spectrum analyser's worker thread.
+//
+// The audio thread only mixes and copies while an analyser is listening, so
+// with the editor closed a tap costs one atomic load per block. Samples that
+// do not fit are dropped; the analyser just sees a gap.
+//==============================================================================
+class SpectrumTap
+{
+public:
+    static constexpr int capacity = 1 << 15;
+
+    // Audio thread. Queues the first numChannels channels mixed to mono.
+    template <typename SampleType>
+    void push (const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept
+    {
+        if (! listening.load (std::memory_order_relaxed) || numChannels <= 0)
+            return;
+
+        const int numSamples = buffer.getNumSamples();
+        const auto scope = fifo.write (juce::jmin (numSamples, fifo.getFreeSpace()));
+        const auto gain = SampleType (1) / static_cast<SampleType> (numChannels);
+
+        auto mixInto = [&] (int start, int count, int sourceOffset)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                SampleType sum = 0;
+                for (int channel = 0; channel < numChannels; ++channel)
+                    sum += buffer.getSample (channel, sourceOffset + i);
+                samples[(size_t) (start + i)] = static_cast<float> (sum * gain);
+            }
+        };
+
+        mixInto (scope.startIndex1, scope.blockSize1, 0);
+        mixInto (scope.startIndex2, scope.blockSize2, scope.blockSize1);
+    }
+
+    // Worker thread. Copies up to maxSamples of the oldest samples into dest
+    // (or discards them if dest is null) and returns how many.
+    int pop (float* dest, int maxSamples) noexcept
+    {
+        const auto scope = fifo.read (juce::jmin (maxSamples, fifo.getNumReady()));
+
+        if (dest != nullptr)
+        {
+            std::copy_n (samples.begin() + scope.startIndex1, scope.blockSize1, dest);
+            std::copy_n (samples.begin() + scope.startIndex2, scope.blockSize2, dest + scope.blockSize1);
+        }
+
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+
+    void setListening (bool shouldListen) noexcept { listening.store (shouldListen, std::memory_order_relaxed); }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<float, capacity> samples {};
+    std::atomic<bool> listening { false };
+};
+
+//==============================================================================
+// Input / output spectrum analyser.
+//
+// A worker thread drains two SpectrumTaps, runs Hann-windowed FFT frames at
+// 50% overlap and keeps a smoothed dB spectrum plus an optional peak hold for
+// each. The message thread only copies the finished arrays, so neither it nor
+// the audio thread pays for a transform. Settings are atomics picked up by
+// the worker before its next frame.
+//==============================================================================
+class SpectrumAnalyser : private juce::Thread
+{
+public:
+    enum FftSize { fft1024 = 0, fft2048, fft4096, fft8192, numFftSizes };
+    static juce::StringArray getFftSizeNames() { return { "1024", "2048", "4096", "8192" }; }
+
+    static constexpr float minDecibels = -90.0f;
+
+    struct Spectrum
+    {
+        // Bin i is i * sampleRate / fftSize Hz; levels in dB
+        int fftSize = 0;
+        std::vector<float> input, output, inputPeak, outputPeak;
+    };
+
+    // Starts active, listening on both taps; they must outlive the analyser
+    SpectrumAnalyser (SpectrumTap& inputTap, SpectrumTap& outputTap);
+    ~SpectrumAnalyser() override;
+
+    void setFftSize (FftSize newSize) noexcept   { requestedFftSize.store (newSize); }
+    // 0 = each frame replaces the last, towards 1 = heavy smoothing
+    void setAveraging (float amount) noexcept    { averaging.store (juce::jlimit (0.0f, 0.99f, amount)); }
+    // Turning peak hold on starts the held peaks over
+    void setPeakHold (bool shouldHold) noexcept;
+
+    // While inactive the taps stop queueing and the worker idles
+    void setActive (bool shouldBeActive) noexcept;
+
+    // Message thread. Copies the latest spectrum into dest if one arrived since
+    // the last call and returns whether it did.
+    bool getLatest (Spectrum& dest);
+
+private:
+    struct Channel
+    {
+        SpectrumTap* tap = nullptr;
+        std::vector<float> history;     // last fftSize samples, circular
+        int historyWrite = 0;
+        int samplesUntilFrame = 0;
+        std::vector<float> level, peak;
+    };
+
+    void run() override;
+    void configure (int sizeIndex);
+    bool analyse (Channel& channel);
+    void publish();
+
+    std::array<Channel, 2> channels;
+
+    static constexpr int minOrder = 10;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> window;      // periodic Hann
+    std::vector<float> fftData;
+    int fftSize = 0;
+    int currentSizeIndex = -1;
+
+    std::atomic<int> requestedFftSize { fft2048 };
+    std::atomic<float> averaging { 0.7f };
+    std::atomic<bool> peakHold { false };
+    std::atomic<bool> peakResetPending { false };
+    std::atomic<bool> active { true };
+
+    juce::CriticalSection publishLock;
+    Spectrum published;
+    bool hasNewSpectrum = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyser)
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+// Wait-free single-producer / single-consumer queue of small fixed-size items,
+// from the audio thread to the editor.
+//
+// Items are copied in and out whole under juce::AbstractFifo's index
+// handshake, so the reader never sees a half written item and neither side
+// takes a lock. When the editor is closed or falls behind, new items are
+// dropped rather than overwriting unread ones.
+//==============================================================================
+template <typename Item, int queueCapacity>
+class SpscQueue
+{
+public:
+    static constexpr int capacity = queueCapacity;
+
+    // Producer. Returns false if the queue was full and the item dropped.
+    bool push (const Item& item) noexcept
+    {
+        const auto scope = fifo.write (1);
+        if (scope.blockSize1 > 0)
+            items[(size_t) scope.startIndex1] = item;
+        else if (scope.blockSize2 > 0)
+            items[(size_t) scope.startIndex2] = item;
+        else
+            return false;
+
+        return true;
+    }
+
+    // Consumer. Copies up to maxItems of the oldest items into dest and
+    // returns how many were copied.
+    int pop (Item* dest, int maxItems) noexcept
+    {
+        const auto scope = fifo.read (juce::jmin (maxItems, fifo.getNumReady()));
+
+        for (int i = 0; i < scope.blockSize1; ++i)
+            dest[i] = items[(size_t) (scope.startIndex1 + i)];
+        for (int i = 0; i < scope.blockSize2; ++i)
+            dest[scope.blockSize1 + i] = items[(size_t) (scope.startIndex2 + i)];
+
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    // Consumer. Drops everything queued so far, e.g. after not listening for a while.
+    void discardPending() noexcept
+    {
+        const auto scope = fifo.read (fifo.getNumReady());
+        juce::ignoreUnused (scope);
+    }
+
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<Item, capacity> items {};
+};
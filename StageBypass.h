@@ -0,0 +1,91 @@
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+// Automatic bypass for one effect stage.
+//
+// Each block the owner reports whether the stage's parameters make it audible
+// and how long it keeps sounding after that stops (its tail). Once a stage is
+// inactive and its tail has run out it fades to dry and is then skipped
+// entirely; when it becomes active again it is reset and faded back in.
+//==============================================================================
+class StageBypass
+{
+public:
+    void prepare (double sampleRate, double crossfadeSeconds = 0.01)
+    {
+        fadeStep = 1.0f / juce::jmax (1, juce::roundToInt (sampleRate * crossfadeSeconds));
+        gain = target = 0.0f;
+        tailRemaining = 0;
+        isFirstBlock = true;
+        justWoke = false;
+    }
+
+    // Call once per block, before isBypassed()
+    void update (bool isActive, int tailSamples, int numSamples)
+    {
+        justWoke = false;
+
+        if (isActive)
+        {
+            justWoke = isBypassed();
+            target = 1.0f;
+            tailRemaining = tailSamples;
+        }
+        else if (tailRemaining > 0)
+        {
+            tailRemaining -= numSamples; // still ringing out, keep running
+        }
+        else
+        {
+            target = 0.0f;
+        }
+
+        // Start in the right state instead of fading in after prepareToPlay
+        if (isFirstBlock)
+        {
+            gain = target;
+            justWoke = isActive;
+            isFirstBlock = false;
+        }
+    }
+
+    bool isBypassed() const noexcept { return gain == 0.0f && target == 0.0f; }
+    bool isFading() const noexcept   { return gain != target; }
+
+    // True on the block the stage comes back from bypass; its state is stale
+    bool needsReset() const noexcept { return justWoke; }
+
+    // processed = dry + (processed - dry) * gain, with gain stepping towards the target
+    template <typename SampleType>
+    void applyCrossfade (const juce::AudioBuffer<SampleType>& dry, juce::AudioBuffer<SampleType>& processed)
+    {
+        const int numSamples = processed.getNumSamples();
+        const int numChannels = juce::jmin (dry.getNumChannels(), processed.getNumChannels());
+        const float step = target > gain ? fadeStep : -fadeStep;
+        float blockEndGain = gain;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* in = dry.getReadPointer (channel);
+            auto* out = processed.getWritePointer (channel);
+            float g = gain;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                g = step > 0.0f ? juce::jmin (target, g + step) : juce::jmax (target, g + step);
+                out[i] = in[i] + (out[i] - in[i]) * static_cast<SampleType> (g);
+            }
+
+            blockEndGain = g;
+        }
+
+        gain = blockEndGain;
+    }
+
+private:
+    float gain = 0.0f, target = 0.0f, fadeStep = 1.0f;
+    int tailRemaining = 0;
+    bool isFirstBlock = true;
+    bool justWoke = false;
+};